@@ -0,0 +1,162 @@
+// --- START OF FILE CpuLoadMeter.h ---
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+// ==============================================================================
+// CPU Load Meter
+// ==============================================================================
+//
+// processBlock times itself with the monotonic high-resolution tick counter
+// and records load = wall time / buffer duration into a lock-free
+// histogram (1 % bins, the last one catching everything from 200 %): a few
+// relaxed atomic adds per block. While stage timing is enabled the blocks
+// also sum their ticks per stage. The consumer turns the counts into
+// windowed statistics by diffing successive snapshots.
+
+namespace CpuStage {
+    enum Id : int { DryCopy = 0, Upsample, Core, Downsample, Mix, NumStages };
+}
+
+class CpuLoadMeter {
+public:
+    static constexpr int numBins = 201;
+
+    struct Stats {
+        int numBlocks = 0;
+        float mean = 0.0f, p95 = 0.0f, p99 = 0.0f, max = 0.0f;   // fractions of the buffer duration
+        int overruns = 0;                                        // blocks that missed their deadline
+        std::array<float, CpuStage::NumStages> stageShare {};    // of the measured time, while enabled
+    };
+
+    // Message thread, before processing starts
+    void prepare(double sampleRate) {
+        secondsPerSample = 1.0 / sampleRate;
+        secondsPerTick = 1.0 / (double)juce::Time::getHighResolutionTicksPerSecond();
+    }
+
+    // Breakdown by stage (a few extra tick reads per block)
+    void setStageTimingEnabled(bool shouldTime) { stageTimingEnabled.store(shouldTime, std::memory_order_relaxed); }
+
+    // --- Audio thread ---
+    // Times the enclosing processBlock, whichever way it returns
+    class BlockScope {
+    public:
+        BlockScope(CpuLoadMeter& m, int numSamples)
+            : meter(m), samples(numSamples), start(juce::Time::getHighResolutionTicks()) {
+            meter.timingStages = meter.stageTimingEnabled.load(std::memory_order_relaxed);
+            meter.blockStageTicks.fill(0);
+        }
+        ~BlockScope() { meter.record(juce::Time::getHighResolutionTicks() - start, samples); }
+        JUCE_DECLARE_NON_COPYABLE(BlockScope)
+
+    private:
+        CpuLoadMeter& meter;
+        int samples;
+        juce::int64 start;
+    };
+
+    // Adds the enclosing scope's ticks to a stage (no-op unless enabled)
+    class StageScope {
+    public:
+        StageScope(CpuLoadMeter& m, CpuStage::Id s)
+            : meter(m), stage(s), start(m.timingStages ? juce::Time::getHighResolutionTicks() : 0) {}
+        ~StageScope() {
+            if (meter.timingStages) meter.blockStageTicks[(size_t)stage] += juce::Time::getHighResolutionTicks() - start;
+        }
+        JUCE_DECLARE_NON_COPYABLE(StageScope)
+
+    private:
+        CpuLoadMeter& meter;
+        CpuStage::Id stage;
+        juce::int64 start;
+    };
+
+    // --- Consumer (one thread) ---
+    // Statistics over the blocks recorded since the previous call
+    Stats takeStats() {
+        Stats st;
+        std::array<std::uint32_t, numBins> window;
+        for (int b = 0; b < numBins; ++b) {
+            const auto now = bins[(size_t)b].load(std::memory_order_relaxed);
+            window[(size_t)b] = now - lastBins[(size_t)b];
+            lastBins[(size_t)b] = now;
+            st.numBlocks += (int)window[(size_t)b];
+            if (b >= 100) st.overruns += (int)window[(size_t)b];
+        }
+
+        const auto sum = loadSumPpm.load(std::memory_order_relaxed);
+        const float maxLoad = windowMax.exchange(0.0f, std::memory_order_relaxed);
+        if (st.numBlocks > 0) {
+            st.mean = (float)((double)(sum - lastLoadSumPpm) * 1.0e-6 / st.numBlocks);
+            st.p95 = percentile(window, st.numBlocks, 0.95);
+            st.p99 = percentile(window, st.numBlocks, 0.99);
+            st.max = maxLoad;
+        }
+        lastLoadSumPpm = sum;
+
+        std::array<std::int64_t, CpuStage::NumStages> stageWindow;
+        std::int64_t stageTotal = 0;
+        for (int s = 0; s < CpuStage::NumStages; ++s) {
+            const auto now = stageTicks[(size_t)s].load(std::memory_order_relaxed);
+            stageWindow[(size_t)s] = now - lastStageTicks[(size_t)s];
+            lastStageTicks[(size_t)s] = now;
+            stageTotal += stageWindow[(size_t)s];
+        }
+        if (stageTotal > 0) {
+            for (int s = 0; s < CpuStage::NumStages; ++s) st.stageShare[(size_t)s] = (float)stageWindow[(size_t)s] / (float)stageTotal;
+        }
+        return st;
+    }
+
+private:
+    void record(juce::int64 ticks, int numSamples) {
+        if (numSamples <= 0 || secondsPerSample <= 0.0) return;
+        const double load = (double)ticks * secondsPerTick / (numSamples * secondsPerSample);
+
+        bins[(size_t)juce::jlimit(0, numBins - 1, (int)(load * 100.0))].fetch_add(1, std::memory_order_relaxed);
+        loadSumPpm.fetch_add((std::int64_t)(load * 1.0e6), std::memory_order_relaxed);
+
+        float current = windowMax.load(std::memory_order_relaxed);
+        while ((float)load > current && !windowMax.compare_exchange_weak(current, (float)load, std::memory_order_relaxed)) {}
+
+        if (timingStages) {
+            for (int s = 0; s < CpuStage::NumStages; ++s)
+                stageTicks[(size_t)s].fetch_add(blockStageTicks[(size_t)s], std::memory_order_relaxed);
+        }
+    }
+
+    // Upper edge of the bin holding the p-th block
+    static float percentile(const std::array<std::uint32_t, numBins>& window, int numBlocks, double p) {
+        const auto target = (std::uint64_t)std::ceil(p * numBlocks);
+        std::uint64_t seen = 0;
+        for (int b = 0; b < numBins; ++b) {
+            seen += window[(size_t)b];
+            if (seen >= target) return (float)(b + 1) * 0.01f;
+        }
+        return (float)numBins * 0.01f;
+    }
+
+    double secondsPerSample = 0.0;
+    double secondsPerTick = 0.0;
+    std::atomic<bool> stageTimingEnabled { false };
+
+    // Shared
+    std::array<std::atomic<std::uint32_t>, numBins> bins {};
+    std::atomic<std::int64_t> loadSumPpm { 0 };
+    std::atomic<float> windowMax { 0.0f };
+    std::array<std::atomic<std::int64_t>, CpuStage::NumStages> stageTicks {};
+
+    // Audio thread only
+    bool timingStages = false;
+    std::array<std::int64_t, CpuStage::NumStages> blockStageTicks {};
+
+    // Consumer only
+    std::array<std::uint32_t, numBins> lastBins {};
+    std::int64_t lastLoadSumPpm = 0;
+    std::array<std::int64_t, CpuStage::NumStages> lastStageTicks {};
+};
@@ -6,390 +6,2226 @@
 #include <array>
 #include <cmath>
 #include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Sample type of the whole DSP chain (oversampler, filters, saturation).
+// 0 = double (default), 1 = float: half the memory traffic and twice the
+// lanes per register, at the cost of ~1e-7 relative precision.
+#ifndef NGS_DSP_FLOAT
+ #define NGS_DSP_FLOAT 0
+#endif
 
 // ==============================================================================
 // 1. High Precision Filter (True 1-Pole + TPT)
 // ==============================================================================
 
+// --- Parameter Ramps ---
+// Start/end values of a smoothed parameter across one block. Filters and
+// kernels derive their coefficients from these once per block (or once per
+// segment while a ramp is active) instead of once per sample.
+struct ValueRamp {
+    double start = 0.0;
+    double end = 0.0;
+
+    bool isConstant() const { return start == end; }
+};
+
+// --- Coefficient Ramp ---
+// A filter coefficient interpolated linearly towards its target. Once the
+// target is reached it holds still and the filters take their static path.
+struct CoeffRamp {
+    double current = 0.0;
+    double target = 0.0;
+    double step = 0.0;
+    int remaining = 0;
+
+    void jumpTo(double value) {
+        current = target = value;
+        step = 0.0;
+        remaining = 0;
+    }
+
+    void rampTo(double value, int numSamples) {
+        if (numSamples <= 0 || value == current) { jumpTo(value); return; }
+        target = value;
+        step = (target - current) / (double)numSamples;
+        remaining = numSamples;
+    }
+
+    bool isRamping() const { return remaining > 0; }
+
+    inline double next() {
+        if (remaining > 0) current = (--remaining == 0) ? target : current + step;
+        return current;
+    }
+
+    void skip(int numSamples) {
+        if (remaining <= 0) return;
+        if (numSamples >= remaining) { jumpTo(target); return; }
+        current += step * (double)numSamples;
+        remaining -= numSamples;
+    }
+};
+
+// Coefficients are plain doubles shared by every lane; the state is V so
+// one filter can run L/R (or more channels) side by side.
+template <typename V>
 class OnePoleFilter {
 public:
-    void reset() { z1 = 0.0; }
-    inline double processLP(double in, double freq, double sr) {
-        double b1 = 1.0 - std::exp(-juce::MathConstants<double>::twoPi * freq / sr);
-        z1 += b1 * (in - z1);
+    void reset() { z1 = V(0.0); }
+
+    static double coefficient(double freq, double sr) {
+        return 1.0 - std::exp(-juce::MathConstants<double>::twoPi * freq / sr);
+    }
+
+    inline V processLP(const V& in, double b1) {
+        z1 = z1 + V(b1) * (in - z1);
         return z1;
     }
-    inline double processHP(double in, double freq, double sr) {
-        double lp = processLP(in, freq, sr);
+    inline V processHP(const V& in, double b1) {
+        V lp = processLP(in, b1);
         return in - lp;
     }
 private:
-    double z1 = 0.0;
+    V z1 = V(0.0);
+};
+
+// Zavalishin TPT state variable stage (same topology as juce::dsp::StateVariableTPTFilter).
+// g = tan(pi * fc / fs), R2 = 1 / Q, h = 1 / (1 + R2 * g + g^2)
+template <typename V>
+class SvfStage {
+public:
+    void reset() { s1 = V(0.0); s2 = V(0.0); }
+
+    template <bool HighPass>
+    inline V process(const V& in, double g, double R2, double h) {
+        const V gv(g);
+        V yHP = V(h) * (in - s1 * V(g + R2) - s2);
+        V yBP = yHP * gv + s1;
+        s1 = yHP * gv + yBP;
+        V yLP = yBP * gv + s2;
+        s2 = yBP * gv + yLP;
+        return HighPass ? yHP : yLP;
+    }
+
+    // Every response of one tick (x = hp + R2 * bp + lp)
+    inline void process(const V& in, double g, double R2, double h, V& lp, V& bp, V& hp) {
+        const V gv(g);
+        hp = V(h) * (in - s1 * V(g + R2) - s2);
+        bp = hp * gv + s1;
+        s1 = hp * gv + bp;
+        lp = bp * gv + s2;
+        s2 = bp * gv + lp;
+    }
+private:
+    V s1 = V(0.0), s2 = V(0.0);
 };
 
-class HighPrecisionFilter {
+template <typename V>
+class BasicHighPrecisionFilter {
 public:
     enum Type { LowPass = 0, HighPass = 1 };
     enum Slope { Slope6dB = 0, Slope12dB, Slope24dB, Slope48dB };
 
     void prepare(double sampleRate) {
-        spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = 4096;
-        spec.numChannels = 1;
-        onePole.reset();
-        for (auto& f : filters) { f.prepare(spec); f.reset(); }
+        currentSampleRate = sampleRate;
+        needsRetune = true;
+        reset();
     }
 
     void reset() {
         onePole.reset();
-        for (auto& f : filters) f.reset();
+        for (auto& s : stages) s.reset();
     }
 
-    void setParams(Type type, double freq, Slope slope) {
-        if (currentType == type && std::abs(currentFreq - freq) < 0.01 && currentSlope == slope && spec.sampleRate == currentSampleRate) {
-            return;
+    // Type/slope plus the cutoff ramp for the next numSamples. The coefficient
+    // is only recomputed when the cutoff target changes and is interpolated
+    // across the ramp; a static cutoff costs nothing here.
+    void setParams(Type type, Slope slope, const ValueRamp& freq, int numSamples) {
+        if (needsRetune || type != currentType || slope != currentSlope) {
+            currentType = type;
+            currentSlope = slope;
+            setupStages();
+            needsRetune = true;
         }
 
-        currentType = type;
-        currentFreq = freq;
-        currentSlope = slope;
-        currentSampleRate = spec.sampleRate;
+        isBypassed = isBypassFrequency(freq.start) && isBypassFrequency(freq.end);
+
+        if (needsRetune) {
+            needsRetune = false;
+            targetFreq = freq.end;
+            coeff.jumpTo(coefficientFor(freq.start));
+            if (!freq.isConstant()) coeff.rampTo(coefficientFor(freq.end), numSamples);
+            return;
+        }
 
-        isBypassed = false;
-        if (type == LowPass && freq >= 19950.0) isBypassed = true;
-        if (type == HighPass && freq <= 20.5) isBypassed = true;
-        if (isBypassed) return;
+        if (freq.end == targetFreq) return;
 
-        if (slope == Slope6dB) return;
+        targetFreq = freq.end;
+        if (freq.isConstant()) coeff.jumpTo(coefficientFor(freq.end));
+        else coeff.rampTo(coefficientFor(freq.end), numSamples);
+    }
 
-        auto filterType = (type == LowPass) ? juce::dsp::StateVariableTPTFilterType::lowpass
-            : juce::dsp::StateVariableTPTFilterType::highpass;
+    void processBlock(V* data, int numSamples) {
+        if (isBypassed) {
+            coeff.skip(numSamples);
+            return;
+        }
+        if (currentType == LowPass) process<false>(data, numSamples);
+        else process<true>(data, numSamples);
+    }
 
-        int numStages = 1;
-        if (slope == Slope12dB) numStages = 1;
-        else if (slope == Slope24dB) numStages = 2;
-        else if (slope == Slope48dB) numStages = 4;
+private:
+    static constexpr int kMaxStages = 4;
 
-        activeStages = numStages;
+    bool isBypassFrequency(double freq) const {
+        return (currentType == LowPass) ? (freq >= 19950.0) : (freq <= 20.5);
+    }
 
-        for (int i = 0; i < 4; ++i) {
-            if (i < numStages) {
-                double q = 0.7071; // Default
+    double coefficientFor(double freq) const {
+        if (currentSlope == Slope6dB) return OnePoleFilter<V>::coefficient(freq, currentSampleRate);
+        const double limited = juce::jlimit(1.0, currentSampleRate * 0.49, freq);
+        return std::tan(juce::MathConstants<double>::pi * limited / currentSampleRate);
+    }
 
-                if (slope == Slope24dB) {
-                    q = (i == 0) ? 0.5412 : 1.3066;
-                }
-                else if (slope == Slope48dB) {
-                    if (i == 0) q = 0.5098;
-                    else if (i == 1) q = 0.6013;
-                    else if (i == 2) q = 0.8999;
-                    else q = 2.5629;
-                }
+    void setupStages() {
+        activeStages = 1;
+        R2[0] = 1.0 / 0.7071; // Default
 
-                filters[i].setType(filterType);
-                filters[i].setCutoffFrequency(freq);
-                filters[i].setResonance(q);
-            }
+        if (currentSlope == Slope24dB) {
+            static constexpr double q[2] = { 0.5412, 1.3066 };
+            activeStages = 2;
+            for (int i = 0; i < 2; ++i) R2[i] = 1.0 / q[i];
+        }
+        else if (currentSlope == Slope48dB) {
+            static constexpr double q[4] = { 0.5098, 0.6013, 0.8999, 2.5629 };
+            activeStages = 4;
+            for (int i = 0; i < 4; ++i) R2[i] = 1.0 / q[i];
         }
     }
 
-    inline double process(double in) {
-        if (isBypassed) return in;
+    template <bool HP>
+    void process(V* data, int numSamples) {
         if (currentSlope == Slope6dB) {
-            if (currentType == LowPass) return onePole.processLP(in, currentFreq, currentSampleRate);
-            else return onePole.processHP(in, currentFreq, currentSampleRate);
+            if (!coeff.isRamping()) {
+                const double b1 = coeff.current;
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = HP ? onePole.processHP(data[i], b1) : onePole.processLP(data[i], b1);
+            }
+            else {
+                for (int i = 0; i < numSamples; ++i) {
+                    const double b1 = coeff.next();
+                    data[i] = HP ? onePole.processHP(data[i], b1) : onePole.processLP(data[i], b1);
+                }
+            }
+            return;
         }
-        double out = in;
-        for (int i = 0; i < activeStages; ++i) {
-            out = filters[i].processSample(0, out);
+
+        if (!coeff.isRamping()) {
+            // Static cutoff: nothing to recompute inside the loop
+            const double g = coeff.current;
+            std::array<double, kMaxStages> h {};
+            for (int s = 0; s < activeStages; ++s) h[s] = 1.0 / (1.0 + R2[s] * g + g * g);
+
+            for (int i = 0; i < numSamples; ++i) {
+                V out = data[i];
+                for (int s = 0; s < activeStages; ++s)
+                    out = stages[s].template process<HP>(out, g, R2[s], h[s]);
+                data[i] = out;
+            }
+            return;
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            const double g = coeff.next();
+            V out = data[i];
+            for (int s = 0; s < activeStages; ++s) {
+                const double h = 1.0 / (1.0 + R2[s] * g + g * g);
+                out = stages[s].template process<HP>(out, g, R2[s], h);
+            }
+            data[i] = out;
         }
-        return out;
     }
 
-private:
-    juce::dsp::ProcessSpec spec;
-    std::array<juce::dsp::StateVariableTPTFilter<double>, 4> filters;
-    OnePoleFilter onePole;
+    std::array<SvfStage<V>, kMaxStages> stages;
+    std::array<double, kMaxStages> R2 {};
+    OnePoleFilter<V> onePole;
+    CoeffRamp coeff;
     double currentSampleRate = 44100.0;
+    double targetFreq = 1000.0;
     Type currentType = LowPass;
     Slope currentSlope = Slope12dB;
-    double currentFreq = 1000.0;
     int activeStages = 1;
     bool isBypassed = false;
+    bool needsRetune = true;
 };
 
-// ==============================================================================
-// 2. Saturation Core (Release Candidate v2)
-// ==============================================================================
+using HighPrecisionFilter = BasicHighPrecisionFilter<double>;
 
-class SaturationCore {
+// --- Multiband Crossover ---
+// Linkwitz-Riley 24 dB/oct band splitter. A crossover is one Butterworth SVF
+// whose LP and HP outputs each run through a second one, so a split costs
+// three stages. The bands below a crossover pass its LR4 allpass instead
+// (lp - sqrt2 * bp + hp of a single SVF), so the bands always sum to an
+// allpass of the input: flat magnitude, phase coherent.
+template <typename V>
+class BasicLinkwitzRileyCrossover {
 public:
+    static constexpr int maxBands = 4;
+
     void prepare(double sampleRate) {
-        if (currentSampleRate == sampleRate) return;
         currentSampleRate = sampleRate;
-
-        dcBlockerCoef = 1.0 - (220.0 / sampleRate);
-
-        double ratio = sampleRate / 44100.0;
-        tapeCoefBase = 1.0 / ratio;
-        tapeDeemphCoef = 0.3 / ratio;
-
-        transCoef = 0.1 / ratio;
-        exciterCoef = std::pow(0.9, 1.0 / ratio);
-
-        sagAttack = 1.0 - std::exp(-1.0 / (0.02 * sampleRate));
-        sagRelease = 1.0 - std::exp(-1.0 / (0.10 * sampleRate));
+        needsRetune = true;
+        reset();
     }
 
     void reset() {
-        lastX = 0.0;
-        lastF = 0.0;
-        tapeFilterState = 0.0;
-        tapeDeemphState = 0.0;
-        transFilterState = 0.0;
-        dcBlockerState = 0.0;
-        lastX_DC = 0.0;
-        sampleHoldVal = 0.0;
-        sampleHoldCounter = 0.0;
-        sagEnvelope = 0.0;
-    }
-
-    // --- Helper Math Functions ---
-    inline double langevin(double x) {
-        if (std::abs(x) < 1.0e-5) return x / 3.0;
-        return (1.0 / std::tanh(x)) - (1.0 / x);
-    }
-
-    inline double intLangevin(double x) {
-        if (std::abs(x) < 1.0e-5) return x * x / 6.0;
-        double v = std::sinh(x) / x;
-        return std::log(std::abs(v));
-    }
-
-    inline double intFrohlich(double x, double b) {
-        if (std::abs(x) < 1.0e-5) return x * x / 2.0;
-        double absX = std::abs(x);
-        return (absX / b) - (std::log(1.0 + b * absX) / (b * b));
-    }
-
-    // --- ADAA Antiderivative Selector ---
-    inline double getADAAFunc(double x, int type, double character) {
-        switch (type) {
-        case 0: // Analog Tape (Normalized 3x)
-            return 3.0 * intLangevin(x);
-
-        case 1: // Tube Triode (Normalized)
-        {
-            double k = 0.5 + character * 1.5;
-            if (x > 0) return (x / k) - (std::log(1.0 + k * x) / (k * k));
-            else return 0.5 * x * x;
-        }
-        case 2: // Tube Pentode
-            return (0.5 * x * x) - (x * x * x * x * 0.08333333);
-        case 3: // Transformer
-            return intFrohlich(x, 0.5 + character * 0.5);
-        case 4: // Console
-            return std::sqrt(1.0 + x * x);
-        case 5: // JFET
-            return (0.5 * x * x) - ((0.2 + character * 0.3) * x * x * x / 3.0);
-        case 6: // BJT (Refined: Linear at 0)
-        {
-            // y = (1 - exp(-kx))/k for x > 0
-            // y = x for x <= 0
-            // Int y (pos) = x/k + exp(-kx)/k^2 - 1/k^2 (Constant adjusted for continuity at 0)
-            // Int y (neg) = 0.5 * x * x
-            double k = 0.1 + character * 5.0;
-            if (x > 0) return (x / k) + (std::exp(-k * x) / (k * k)) - (1.0 / (k * k));
-            else return 0.5 * x * x;
-        }
-        case 7: // Diode (Normalized)
-        {
-            double k = 1.5 + character * 3.0;
-            double absX = std::abs(x);
-            return (absX + std::exp(-k * absX) / k) / k;
-        }
-        case 8: // Soft Tanh
-            if (std::abs(x) > 10.0) return std::abs(x) - 0.693147;
-            return std::log(std::cosh(x));
-        case 9: // Hard Clip
-            if (x < -1.0) return -x - 0.5;
-            if (x > 1.0) return x - 0.5;
-            return 0.5 * x * x;
-        case 10: // Wavefold (Refined Range)
-        {
-            // y = sin(w * x)
-            // Int y = -cos(w * x) / w
-            double w = (0.5 + character * 2.5) * juce::MathConstants<double>::pi; // Range 0.5pi to 3.0pi
-            return -std::cos(x * w) / w;
-        }
-        case 11: // Rectify
-            return 0.5 * x * std::abs(x);
-        default: return 0.0;
-        }
-    }
-
-    // --- Auto Makeup Gain ---
-    inline double getMakeupGain(int type) {
-        switch (type) {
-        case 2: return 1.2;  // Pentode
-        case 3: return 1.1;  // Transformer
-        case 5: return 1.4;  // JFET
-        case 6: return 1.0;  // BJT (Now Unity at 0dB)
-        case 10: return 3.2; // Wavefold (Compensate for 0.2x input scaling)
-        default: return 1.0;
-        }
+        for (int k = 0; k < maxBands - 1; ++k) resetCrossover(k);
     }
 
-    // --- Main Process ---
-    inline double process(double in, int type, double driveDB, double character) {
-        // 1. Dynamic Bias (Sag)
-        double sagMod = 1.0;
-        if (type <= 6) {
-            double inputPower = std::abs(in);
-            if (inputPower > sagEnvelope) sagEnvelope += sagAttack * (inputPower - sagEnvelope);
-            else sagEnvelope += sagRelease * (inputPower - sagEnvelope);
+    // Band count plus the ascending crossover ramps (numBands - 1 of them)
+    // for the next numSamples
+    void setParams(int numBands, const ValueRamp* freqs, int numSamples) {
+        numBands = juce::jlimit(1, maxBands, numBands);
+        if (numBands != activeBands) {
+            // Newly added crossovers start from silence
+            for (int k = activeBands - 1; k < numBands - 1; ++k) resetCrossover(k);
+            activeBands = numBands;
+            needsRetune = true;
+        }
 
-            double sagAmount = juce::jlimit(0.0, 1.0, driveDB / 12.0);
-            sagMod = 1.0 - (sagEnvelope * 0.15 * sagAmount);
+        for (int k = 0; k < activeBands - 1; ++k) {
+            auto& split = splits[(size_t)k];
+            if (needsRetune) {
+                split.targetFreq = freqs[k].end;
+                split.coeff.jumpTo(coefficientFor(freqs[k].start));
+                if (!freqs[k].isConstant()) split.coeff.rampTo(coefficientFor(freqs[k].end), numSamples);
+            }
+            else if (freqs[k].end != split.targetFreq) {
+                split.targetFreq = freqs[k].end;
+                if (freqs[k].isConstant()) split.coeff.jumpTo(coefficientFor(freqs[k].end));
+                else split.coeff.rampTo(coefficientFor(freqs[k].end), numSamples);
+            }
         }
+        needsRetune = false;
+    }
 
-        double drive = std::pow(10.0, driveDB / 20.0);
-        double x = in * drive * sagMod;
+    int getNumBands() const { return activeBands; }
 
-        // Pre-Processing
-        if (type == 0) { // Analog Tape
-            double coef = (0.05 + 0.55 * character) * tapeCoefBase;
-            double w = x - coef * tapeFilterState;
-            tapeFilterState = w;
-            x = w + coef * x;
-        }
-        if (type == 3) { // Transformer
-            transFilterState += transCoef * (x - transFilterState);
-            double low = transFilterState;
-            x = x + low * (character * 2.0);
-        }
-        if (type == 8 && character > 0.0) { // Soft Tanh
-            x += character * 0.5;
+    // bands[0] is the lowest; `in` may alias bands[0]
+    void process(const V* in, V* const* bands, int numSamples) {
+        const int numSplits = activeBands - 1;
+        if (numSplits <= 0) {
+            if (bands[0] != in) std::copy(in, in + numSamples, bands[0]);
+            return;
         }
 
-        double dryRect = x;
-
-        // Input Scaling for Wavefold
-        if (type == 10) x *= 0.2; // Wavefold Tame
+        bool ramping = false;
+        for (int k = 0; k < numSplits; ++k) ramping = ramping || splits[(size_t)k].coeff.isRamping();
 
-        // Core Saturation
-        bool useADAA = (type <= 11);
-        double out = 0.0;
-
-        if (useADAA) {
-            double Fx = getADAAFunc(x, type, character);
-            if (std::abs(x - lastX) < 1.0e-6) {
-                switch (type) {
-                case 0: out = 3.0 * langevin(x); break;
-                case 1: {
-                    double k = 0.5 + character * 1.5;
-                    out = (x > 0) ? (x / (1.0 + k * x)) : x;
-                    break;
-                }
-                case 2: out = x - (x * x * x / 3.0); break;
-                case 3: out = x / (1.0 + (0.5 + character * 0.5) * std::abs(x)); break;
-                case 4: out = x / std::sqrt(1.0 + x * x); break;
-                case 5: out = x - (0.2 + character * 0.3) * x * x; break;
-                case 6: { // BJT (Refined)
-                    double k = 0.1 + character * 5.0;
-                    out = (x > 0) ? ((1.0 - std::exp(-k * x)) / k) : x;
-                    break;
-                }
-                case 7: { // Diode
-                    double k = 1.5 + character * 3.0;
-                    out = (x > 0) ? ((1.0 - std::exp(-k * x)) / k) : ((-1.0 + std::exp(k * x)) / k);
-                    break;
-                }
-                case 8: out = std::tanh(x); break;
-                case 9: out = juce::jlimit(-1.0, 1.0, x); break;
-                case 10: { // Wavefold (Refined Range)
-                    double w = (0.5 + character * 2.5) * juce::MathConstants<double>::pi;
-                    out = std::sin(x * w);
-                    break;
-                }
-                case 11: out = std::abs(x); break;
-                }
+        std::array<double, maxBands - 1> g {}, h {};
+        auto updateCoefficients = [&](bool advance) {
+            for (int k = 0; k < numSplits; ++k) {
+                g[(size_t)k] = advance ? splits[(size_t)k].coeff.next() : splits[(size_t)k].coeff.current;
+                h[(size_t)k] = 1.0 / (1.0 + kButterworthR2 * g[(size_t)k] + g[(size_t)k] * g[(size_t)k]);
             }
-            else {
-                out = (Fx - lastF) / (x - lastX);
+        };
+
+        updateCoefficients(false);
+        for (int i = 0; i < numSamples; ++i) {
+            if (ramping) updateCoefficients(true);
+
+            std::array<V, maxBands> out;
+            V rest = in[i];
+            for (int k = 0; k < numSplits; ++k) {
+                auto& split = splits[(size_t)k];
+                V lp, bp, hp;
+                split.shared.process(rest, g[(size_t)k], kButterworthR2, h[(size_t)k], lp, bp, hp);
+                out[(size_t)k] = split.low.template process<false>(lp, g[(size_t)k], kButterworthR2, h[(size_t)k]);
+                rest = split.high.template process<true>(hp, g[(size_t)k], kButterworthR2, h[(size_t)k]);
             }
-            lastX = x;
-            lastF = Fx;
-        }
-        else {
-            switch (type) {
-            case 12: // Bitcrush
-            {
-                double rateDiv = 1.0 + (character * 49.0);
-                sampleHoldCounter += 1.0;
-                if (sampleHoldCounter >= rateDiv) {
-                    sampleHoldCounter = 0.0;
-                    sampleHoldVal = x;
+            out[(size_t)numSplits] = rest;
+
+            // Phase compensation: band j passes the allpass of every crossover above it
+            for (int j = 0; j < numSplits - 1; ++j) {
+                for (int k = j + 1; k < numSplits; ++k) {
+                    V lp, bp, hp;
+                    allpasses[(size_t)j][(size_t)k].process(out[(size_t)j], g[(size_t)k], kButterworthR2, h[(size_t)k], lp, bp, hp);
+                    out[(size_t)j] = lp - V(kButterworthR2) * bp + hp;
                 }
-                double heldSignal = sampleHoldVal;
-                double bits = 16.0 - (character * 14.0);
-                if (bits < 1.0) bits = 1.0;
-                double steps = std::pow(2.0, bits);
-                out = std::round(heldSignal * steps) / steps;
-                break;
             }
-            case 13: // Exciter
-            {
-                double hpf = x - exciterCoef * lastX;
-                double k = 0.5;
-                double drivenHPF = hpf * 1.5;
-                double dist = (drivenHPF > 0) ? (drivenHPF / (1.0 + k * drivenHPF)) : drivenHPF;
-                out = x + (character * 2.0) * dist;
-                break;
+
+            for (int b = 0; b <= numSplits; ++b) bands[b][i] = out[(size_t)b];
+        }
+    }
+
+private:
+    static constexpr double kButterworthR2 = 1.4142135623730951; // 1 / Q, Q = 1/sqrt2
+
+    struct Split {
+        SvfStage<V> shared, low, high;
+        CoeffRamp coeff;
+        double targetFreq = 1000.0;
+    };
+
+    double coefficientFor(double freq) const {
+        const double limited = juce::jlimit(1.0, currentSampleRate * 0.49, freq);
+        return std::tan(juce::MathConstants<double>::pi * limited / currentSampleRate);
+    }
+
+    void resetCrossover(int k) {
+        auto& split = splits[(size_t)k];
+        split.shared.reset(); split.low.reset(); split.high.reset();
+        for (auto& row : allpasses) row[(size_t)k].reset();
+    }
+
+    std::array<Split, maxBands - 1> splits;
+    std::array<std::array<SvfStage<V>, maxBands - 1>, maxBands - 1> allpasses;  // [band][crossover]
+    double currentSampleRate = 44100.0;
+    int activeBands = 1;
+    bool needsRetune = true;
+};
+
+// ==============================================================================
+// 2. Lane Math (SIMD-friendly sample vectors)
+// ==============================================================================
+//
+// LaneVec<T, N> holds one sample per channel and is what the saturation
+// kernels run on when several channels share a core. Every operation is a
+// short elementwise loop over an aligned array, which the compiler maps onto
+// SSE2/NEON registers. Comparisons return all-ones/all-zero bit masks and
+// branches become bitwise blends, the usual SIMD idiom. (juce::dsp::SIMDRegister
+// has no division or bit casts, both of which the ADAA quotient and the
+// exp/log range reduction need.)
+//
+// SatMath implements each function once as a template over V, so the scalar
+// core (V = double) and the lane cores (double or float lanes) share the same
+// code. FloatFormat supplies the bit layout the range reductions rely on.
+
+template <typename T> struct LaneBits;
+template <> struct LaneBits<double> { using type = std::uint64_t; };
+template <> struct LaneBits<float> { using type = std::uint32_t; };
+template <> struct LaneBits<std::uint64_t> { using type = std::uint64_t; };
+template <> struct LaneBits<std::uint32_t> { using type = std::uint32_t; };
+
+// IEEE-754 layout the bit-level math (range reduction, sign tricks) relies on
+template <typename T> struct FloatFormat;
+
+template <> struct FloatFormat<double> {
+    using Bits = std::uint64_t;
+    static constexpr int numBits = 64;
+    static constexpr int mantissaBits = 52;
+    static constexpr Bits exponentBias = 1023;
+    static constexpr Bits exponentMask = 0x7ff;
+    static constexpr Bits mantissaMask = 0x000fffffffffffffull;
+    static constexpr Bits signBit = 0x8000000000000000ull;
+    static constexpr double roundShifter = 6755399441055744.0; // 1.5 * 2^52: x + s - s rounds to nearest
+    static constexpr double expMin = -708.0, expMax = 709.0;
+    static constexpr double ln2Hi = 6.93145751953125E-1, ln2Lo = 1.42860682030941723212E-6;
+    static constexpr double pio2Hi = 1.57079632673412561417e+00, pio2Lo = 6.07710050650619224932e-11;
+};
+
+template <> struct FloatFormat<float> {
+    using Bits = std::uint32_t;
+    static constexpr int numBits = 32;
+    static constexpr int mantissaBits = 23;
+    static constexpr Bits exponentBias = 127;
+    static constexpr Bits exponentMask = 0xff;
+    static constexpr Bits mantissaMask = 0x007fffffu;
+    static constexpr Bits signBit = 0x80000000u;
+    static constexpr float roundShifter = 12582912.0f; // 1.5 * 2^23
+    static constexpr float expMin = -87.0f, expMax = 88.0f;
+    static constexpr float ln2Hi = 0.693359375f, ln2Lo = -2.12194440e-4f;
+    static constexpr float pio2Hi = 1.5703125f, pio2Lo = 4.83826794897e-4f;
+};
+
+template <typename T, int N>
+struct alignas(sizeof(T) * N) LaneVec {
+    static constexpr int numLanes = N;
+    using Sample = T;
+    using Mask = LaneVec<typename LaneBits<T>::type, N>;
+
+    T v[N];
+
+    LaneVec() = default;
+    LaneVec(T scalar) { for (int i = 0; i < N; ++i) v[i] = scalar; }
+
+    static LaneVec fromArray(const T* p) { LaneVec r; for (int i = 0; i < N; ++i) r.v[i] = p[i]; return r; }
+    void toArray(T* p) const { for (int i = 0; i < N; ++i) p[i] = v[i]; }
+    T get(int i) const { return v[i]; }
+
+    template <typename Fn>
+    static LaneVec map(const LaneVec& a, Fn&& fn) {
+        LaneVec r;
+        for (int i = 0; i < N; ++i) r.v[i] = fn(a.v[i]);
+        return r;
+    }
+
+#define NGS_LANE_BINARY_OP(op) \
+    friend LaneVec operator op(const LaneVec& a, const LaneVec& b) { LaneVec r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] op b.v[i]; return r; } \
+    LaneVec& operator op##=(const LaneVec& b) { for (int i = 0; i < N; ++i) v[i] = v[i] op b.v[i]; return *this; }
+
+    NGS_LANE_BINARY_OP(+)
+    NGS_LANE_BINARY_OP(-)
+    NGS_LANE_BINARY_OP(*)
+    NGS_LANE_BINARY_OP(/)
+    NGS_LANE_BINARY_OP(&)
+    NGS_LANE_BINARY_OP(|)
+    NGS_LANE_BINARY_OP(^)
+#undef NGS_LANE_BINARY_OP
+
+    friend LaneVec operator<<(const LaneVec& a, int s) { LaneVec r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] << s; return r; }
+    friend LaneVec operator>>(const LaneVec& a, int s) { LaneVec r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] >> s; return r; }
+    friend LaneVec operator~(const LaneVec& a) { LaneVec r; for (int i = 0; i < N; ++i) r.v[i] = ~a.v[i]; return r; }
+    friend LaneVec operator-(const LaneVec& a) { LaneVec r; for (int i = 0; i < N; ++i) r.v[i] = -a.v[i]; return r; }
+
+#define NGS_LANE_COMPARE_OP(op) \
+    friend Mask operator op(const LaneVec& a, const LaneVec& b) { Mask r; for (int i = 0; i < N; ++i) r.v[i] = (a.v[i] op b.v[i]) ? ~typename LaneBits<T>::type(0) : 0; return r; }
+
+    NGS_LANE_COMPARE_OP(<)
+    NGS_LANE_COMPARE_OP(>)
+    NGS_LANE_COMPARE_OP(<=)
+    NGS_LANE_COMPARE_OP(>=)
+#undef NGS_LANE_COMPARE_OP
+};
+
+// --- Native 128-bit specializations (double2 for stereo, float4) ---
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+ #define NGS_LANES_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #define NGS_LANES_NEON 1
+#endif
+
+#if NGS_LANES_SSE2 || NGS_LANES_NEON
+#if NGS_LANES_SSE2
+ #include <emmintrin.h>
+ using NativeF64x2 = __m128d;
+ using NativeU64x2 = __m128i;
+#else
+ #include <arm_neon.h>
+ using NativeF64x2 = float64x2_t;
+ using NativeU64x2 = uint64x2_t;
+#endif
+
+template <>
+struct alignas(16) LaneVec<std::uint64_t, 2> {
+    static constexpr int numLanes = 2;
+    using Sample = std::uint64_t;
+
+    NativeU64x2 v;
+
+    LaneVec() = default;
+   #if NGS_LANES_SSE2
+    LaneVec(std::uint64_t scalar) : v(_mm_set1_epi64x((long long)scalar)) {}
+   #else
+    LaneVec(std::uint64_t scalar) : v(vdupq_n_u64(scalar)) {}
+   #endif
+    static LaneVec wrap(NativeU64x2 x) { LaneVec r; r.v = x; return r; }
+   #if NGS_LANES_SSE2
+    void toArray(std::uint64_t* p) const { _mm_storeu_si128((__m128i*)p, v); }
+   #else
+    void toArray(std::uint64_t* p) const { vst1q_u64(p, v); }
+   #endif
+
+   #if NGS_LANES_SSE2
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(_mm_add_epi64(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(_mm_sub_epi64(a.v, b.v)); }
+    friend LaneVec operator&(const LaneVec& a, const LaneVec& b) { return wrap(_mm_and_si128(a.v, b.v)); }
+    friend LaneVec operator|(const LaneVec& a, const LaneVec& b) { return wrap(_mm_or_si128(a.v, b.v)); }
+    friend LaneVec operator^(const LaneVec& a, const LaneVec& b) { return wrap(_mm_xor_si128(a.v, b.v)); }
+    friend LaneVec operator~(const LaneVec& a) { return wrap(_mm_xor_si128(a.v, _mm_set1_epi32(-1))); }
+    friend LaneVec operator<<(const LaneVec& a, int s) { return wrap(_mm_sll_epi64(a.v, _mm_cvtsi32_si128(s))); }
+    friend LaneVec operator>>(const LaneVec& a, int s) { return wrap(_mm_srl_epi64(a.v, _mm_cvtsi32_si128(s))); }
+   #else
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(vaddq_u64(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(vsubq_u64(a.v, b.v)); }
+    friend LaneVec operator&(const LaneVec& a, const LaneVec& b) { return wrap(vandq_u64(a.v, b.v)); }
+    friend LaneVec operator|(const LaneVec& a, const LaneVec& b) { return wrap(vorrq_u64(a.v, b.v)); }
+    friend LaneVec operator^(const LaneVec& a, const LaneVec& b) { return wrap(veorq_u64(a.v, b.v)); }
+    friend LaneVec operator~(const LaneVec& a) { return wrap(veorq_u64(a.v, vdupq_n_u64(~0ull))); }
+    friend LaneVec operator<<(const LaneVec& a, int s) { return wrap(vshlq_u64(a.v, vdupq_n_s64(s))); }
+    friend LaneVec operator>>(const LaneVec& a, int s) { return wrap(vshlq_u64(a.v, vdupq_n_s64(-s))); }
+   #endif
+};
+
+template <>
+struct alignas(16) LaneVec<double, 2> {
+    static constexpr int numLanes = 2;
+    using Sample = double;
+    using Mask = LaneVec<std::uint64_t, 2>;
+
+    NativeF64x2 v;
+
+    LaneVec() = default;
+   #if NGS_LANES_SSE2
+    LaneVec(double scalar) : v(_mm_set1_pd(scalar)) {}
+    static LaneVec fromArray(const double* p) { return wrap(_mm_loadu_pd(p)); }
+    void toArray(double* p) const { _mm_storeu_pd(p, v); }
+   #else
+    LaneVec(double scalar) : v(vdupq_n_f64(scalar)) {}
+    static LaneVec fromArray(const double* p) { return wrap(vld1q_f64(p)); }
+    void toArray(double* p) const { vst1q_f64(p, v); }
+   #endif
+    static LaneVec wrap(NativeF64x2 x) { LaneVec r; r.v = x; return r; }
+
+    double get(int i) const { double a[2]; toArray(a); return a[i]; }
+
+    template <typename Fn>
+    static LaneVec map(const LaneVec& x, Fn&& fn) {
+        double a[2];
+        x.toArray(a);
+        a[0] = fn(a[0]);
+        a[1] = fn(a[1]);
+        return fromArray(a);
+    }
+
+   #if NGS_LANES_SSE2
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(_mm_add_pd(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(_mm_sub_pd(a.v, b.v)); }
+    friend LaneVec operator*(const LaneVec& a, const LaneVec& b) { return wrap(_mm_mul_pd(a.v, b.v)); }
+    friend LaneVec operator/(const LaneVec& a, const LaneVec& b) { return wrap(_mm_div_pd(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a) { return wrap(_mm_xor_pd(a.v, _mm_set1_pd(-0.0))); }
+    friend Mask operator<(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castpd_si128(_mm_cmplt_pd(a.v, b.v))); }
+    friend Mask operator>(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castpd_si128(_mm_cmpgt_pd(a.v, b.v))); }
+    friend Mask operator<=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castpd_si128(_mm_cmple_pd(a.v, b.v))); }
+    friend Mask operator>=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castpd_si128(_mm_cmpge_pd(a.v, b.v))); }
+   #else
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(vaddq_f64(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(vsubq_f64(a.v, b.v)); }
+    friend LaneVec operator*(const LaneVec& a, const LaneVec& b) { return wrap(vmulq_f64(a.v, b.v)); }
+    friend LaneVec operator/(const LaneVec& a, const LaneVec& b) { return wrap(vdivq_f64(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a) { return wrap(vnegq_f64(a.v)); }
+    friend Mask operator<(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcltq_f64(a.v, b.v)); }
+    friend Mask operator>(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcgtq_f64(a.v, b.v)); }
+    friend Mask operator<=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcleq_f64(a.v, b.v)); }
+    friend Mask operator>=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcgeq_f64(a.v, b.v)); }
+   #endif
+
+    LaneVec& operator+=(const LaneVec& b) { return *this = *this + b; }
+    LaneVec& operator-=(const LaneVec& b) { return *this = *this - b; }
+    LaneVec& operator*=(const LaneVec& b) { return *this = *this * b; }
+    LaneVec& operator/=(const LaneVec& b) { return *this = *this / b; }
+};
+
+#if NGS_LANES_SSE2
+ using NativeF32x4 = __m128;
+ using NativeU32x4 = __m128i;
+#else
+ using NativeF32x4 = float32x4_t;
+ using NativeU32x4 = uint32x4_t;
+#endif
+
+template <>
+struct alignas(16) LaneVec<std::uint32_t, 4> {
+    static constexpr int numLanes = 4;
+    using Sample = std::uint32_t;
+
+    NativeU32x4 v;
+
+    LaneVec() = default;
+   #if NGS_LANES_SSE2
+    LaneVec(std::uint32_t scalar) : v(_mm_set1_epi32((int)scalar)) {}
+    void toArray(std::uint32_t* p) const { _mm_storeu_si128((__m128i*)p, v); }
+   #else
+    LaneVec(std::uint32_t scalar) : v(vdupq_n_u32(scalar)) {}
+    void toArray(std::uint32_t* p) const { vst1q_u32(p, v); }
+   #endif
+    static LaneVec wrap(NativeU32x4 x) { LaneVec r; r.v = x; return r; }
+
+   #if NGS_LANES_SSE2
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(_mm_add_epi32(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(_mm_sub_epi32(a.v, b.v)); }
+    friend LaneVec operator&(const LaneVec& a, const LaneVec& b) { return wrap(_mm_and_si128(a.v, b.v)); }
+    friend LaneVec operator|(const LaneVec& a, const LaneVec& b) { return wrap(_mm_or_si128(a.v, b.v)); }
+    friend LaneVec operator^(const LaneVec& a, const LaneVec& b) { return wrap(_mm_xor_si128(a.v, b.v)); }
+    friend LaneVec operator~(const LaneVec& a) { return wrap(_mm_xor_si128(a.v, _mm_set1_epi32(-1))); }
+    friend LaneVec operator<<(const LaneVec& a, int s) { return wrap(_mm_sll_epi32(a.v, _mm_cvtsi32_si128(s))); }
+    friend LaneVec operator>>(const LaneVec& a, int s) { return wrap(_mm_srl_epi32(a.v, _mm_cvtsi32_si128(s))); }
+   #else
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(vaddq_u32(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(vsubq_u32(a.v, b.v)); }
+    friend LaneVec operator&(const LaneVec& a, const LaneVec& b) { return wrap(vandq_u32(a.v, b.v)); }
+    friend LaneVec operator|(const LaneVec& a, const LaneVec& b) { return wrap(vorrq_u32(a.v, b.v)); }
+    friend LaneVec operator^(const LaneVec& a, const LaneVec& b) { return wrap(veorq_u32(a.v, b.v)); }
+    friend LaneVec operator~(const LaneVec& a) { return wrap(vmvnq_u32(a.v)); }
+    friend LaneVec operator<<(const LaneVec& a, int s) { return wrap(vshlq_u32(a.v, vdupq_n_s32(s))); }
+    friend LaneVec operator>>(const LaneVec& a, int s) { return wrap(vshlq_u32(a.v, vdupq_n_s32(-s))); }
+   #endif
+};
+
+template <>
+struct alignas(16) LaneVec<float, 4> {
+    static constexpr int numLanes = 4;
+    using Sample = float;
+    using Mask = LaneVec<std::uint32_t, 4>;
+
+    NativeF32x4 v;
+
+    LaneVec() = default;
+   #if NGS_LANES_SSE2
+    LaneVec(float scalar) : v(_mm_set1_ps(scalar)) {}
+    static LaneVec fromArray(const float* p) { return wrap(_mm_loadu_ps(p)); }
+    void toArray(float* p) const { _mm_storeu_ps(p, v); }
+   #else
+    LaneVec(float scalar) : v(vdupq_n_f32(scalar)) {}
+    static LaneVec fromArray(const float* p) { return wrap(vld1q_f32(p)); }
+    void toArray(float* p) const { vst1q_f32(p, v); }
+   #endif
+    static LaneVec wrap(NativeF32x4 x) { LaneVec r; r.v = x; return r; }
+
+    float get(int i) const { float a[4]; toArray(a); return a[i]; }
+
+    template <typename Fn>
+    static LaneVec map(const LaneVec& x, Fn&& fn) {
+        float a[4];
+        x.toArray(a);
+        for (auto& s : a) s = fn(s);
+        return fromArray(a);
+    }
+
+   #if NGS_LANES_SSE2
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(_mm_add_ps(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(_mm_sub_ps(a.v, b.v)); }
+    friend LaneVec operator*(const LaneVec& a, const LaneVec& b) { return wrap(_mm_mul_ps(a.v, b.v)); }
+    friend LaneVec operator/(const LaneVec& a, const LaneVec& b) { return wrap(_mm_div_ps(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a) { return wrap(_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))); }
+    friend Mask operator<(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castps_si128(_mm_cmplt_ps(a.v, b.v))); }
+    friend Mask operator>(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castps_si128(_mm_cmpgt_ps(a.v, b.v))); }
+    friend Mask operator<=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castps_si128(_mm_cmple_ps(a.v, b.v))); }
+    friend Mask operator>=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(_mm_castps_si128(_mm_cmpge_ps(a.v, b.v))); }
+   #else
+    friend LaneVec operator+(const LaneVec& a, const LaneVec& b) { return wrap(vaddq_f32(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a, const LaneVec& b) { return wrap(vsubq_f32(a.v, b.v)); }
+    friend LaneVec operator*(const LaneVec& a, const LaneVec& b) { return wrap(vmulq_f32(a.v, b.v)); }
+    friend LaneVec operator/(const LaneVec& a, const LaneVec& b) { return wrap(vdivq_f32(a.v, b.v)); }
+    friend LaneVec operator-(const LaneVec& a) { return wrap(vnegq_f32(a.v)); }
+    friend Mask operator<(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcltq_f32(a.v, b.v)); }
+    friend Mask operator>(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcgtq_f32(a.v, b.v)); }
+    friend Mask operator<=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcleq_f32(a.v, b.v)); }
+    friend Mask operator>=(const LaneVec& a, const LaneVec& b) { return Mask::wrap(vcgeq_f32(a.v, b.v)); }
+   #endif
+
+    LaneVec& operator+=(const LaneVec& b) { return *this = *this + b; }
+    LaneVec& operator-=(const LaneVec& b) { return *this = *this - b; }
+    LaneVec& operator*=(const LaneVec& b) { return *this = *this * b; }
+    LaneVec& operator/=(const LaneVec& b) { return *this = *this / b; }
+};
+#endif
+
+// Lane count of a kernel value type (1 for plain scalars)
+template <typename V> struct LaneTraits { static constexpr int numLanes = 1; using Sample = V; };
+template <typename T, int N> struct LaneTraits<LaneVec<T, N>> { static constexpr int numLanes = N; using Sample = T; };
+
+namespace SatMath {
+    template <typename V> using SampleOf = typename LaneTraits<V>::Sample;
+    template <typename V> using FormatOf = FloatFormat<SampleOf<V>>;
+
+    // --- Bit casts ---
+    inline std::uint64_t toBits(double x) { std::uint64_t b; std::memcpy(&b, &x, sizeof(b)); return b; }
+    inline double fromBits(std::uint64_t b) { double x; std::memcpy(&x, &b, sizeof(x)); return x; }
+    inline std::uint32_t toBits(float x) { std::uint32_t b; std::memcpy(&b, &x, sizeof(b)); return b; }
+    inline float fromBits(std::uint32_t b) { float x; std::memcpy(&x, &b, sizeof(x)); return x; }
+
+    template <int N> LaneVec<std::uint64_t, N> toBits(const LaneVec<double, N>& x) { LaneVec<std::uint64_t, N> b; std::memcpy(b.v, x.v, sizeof(b.v)); return b; }
+    template <int N> LaneVec<double, N> fromBits(const LaneVec<std::uint64_t, N>& b) { LaneVec<double, N> x; std::memcpy(x.v, b.v, sizeof(x.v)); return x; }
+    template <int N> LaneVec<std::uint32_t, N> toBits(const LaneVec<float, N>& x) { LaneVec<std::uint32_t, N> b; std::memcpy(b.v, x.v, sizeof(b.v)); return b; }
+    template <int N> LaneVec<float, N> fromBits(const LaneVec<std::uint32_t, N>& b) { LaneVec<float, N> x; std::memcpy(x.v, b.v, sizeof(x.v)); return x; }
+
+   #if NGS_LANES_SSE2
+    inline LaneVec<std::uint64_t, 2> toBits(const LaneVec<double, 2>& x) { return LaneVec<std::uint64_t, 2>::wrap(_mm_castpd_si128(x.v)); }
+    inline LaneVec<double, 2> fromBits(const LaneVec<std::uint64_t, 2>& b) { return LaneVec<double, 2>::wrap(_mm_castsi128_pd(b.v)); }
+    inline LaneVec<std::uint32_t, 4> toBits(const LaneVec<float, 4>& x) { return LaneVec<std::uint32_t, 4>::wrap(_mm_castps_si128(x.v)); }
+    inline LaneVec<float, 4> fromBits(const LaneVec<std::uint32_t, 4>& b) { return LaneVec<float, 4>::wrap(_mm_castsi128_ps(b.v)); }
+   #elif NGS_LANES_NEON
+    inline LaneVec<std::uint64_t, 2> toBits(const LaneVec<double, 2>& x) { return LaneVec<std::uint64_t, 2>::wrap(vreinterpretq_u64_f64(x.v)); }
+    inline LaneVec<double, 2> fromBits(const LaneVec<std::uint64_t, 2>& b) { return LaneVec<double, 2>::wrap(vreinterpretq_f64_u64(b.v)); }
+    inline LaneVec<std::uint32_t, 4> toBits(const LaneVec<float, 4>& x) { return LaneVec<std::uint32_t, 4>::wrap(vreinterpretq_u32_f32(x.v)); }
+    inline LaneVec<float, 4> fromBits(const LaneVec<std::uint32_t, 4>& b) { return LaneVec<float, 4>::wrap(vreinterpretq_f32_u32(b.v)); }
+   #endif
+
+    // --- Selection ---
+    // blend() takes an integer bit mask (all ones = a), select() the result of a comparison.
+    template <typename V, typename U>
+    V blend(const U& mask, const V& a, const V& b) { return fromBits((toBits(a) & mask) | (toBits(b) & ~mask)); }
+
+    inline double select(bool m, double a, double b) { return m ? a : b; }
+    inline float select(bool m, float a, float b) { return m ? a : b; }
+    template <typename T, int N> LaneVec<T, N> select(const typename LaneVec<T, N>::Mask& m, const LaneVec<T, N>& a, const LaneVec<T, N>& b) { return blend(m, a, b); }
+
+    inline bool any(bool m) { return m; }
+    template <typename B, int N> bool any(const LaneVec<B, N>& m) {
+        B r = 0;
+        for (int i = 0; i < N; ++i) r |= m.v[i];
+        return r != 0;
+    }
+   #if NGS_LANES_SSE2
+    inline bool any(const LaneVec<std::uint64_t, 2>& m) { return _mm_movemask_pd(_mm_castsi128_pd(m.v)) != 0; }
+    inline bool any(const LaneVec<std::uint32_t, 4>& m) { return _mm_movemask_ps(_mm_castsi128_ps(m.v)) != 0; }
+   #elif NGS_LANES_NEON
+    inline bool any(const LaneVec<std::uint64_t, 2>& m) { return vmaxvq_u32(vreinterpretq_u32_u64(m.v)) != 0; }
+    inline bool any(const LaneVec<std::uint32_t, 4>& m) { return vmaxvq_u32(m.v) != 0; }
+   #endif
+
+    // --- Elementary ---
+    template <typename V> V abs(const V& x) { return fromBits(toBits(x) & ~FormatOf<V>::signBit); }
+    template <typename V> V copySign(const V& mag, const V& sgn) {
+        constexpr auto signBit = FormatOf<V>::signBit;
+        return fromBits((toBits(mag) & ~signBit) | (toBits(sgn) & signBit));
+    }
+
+    inline double min(double a, double b) { return a < b ? a : b; }
+    inline double max(double a, double b) { return a > b ? a : b; }
+    inline float min(float a, float b) { return a < b ? a : b; }
+    inline float max(float a, float b) { return a > b ? a : b; }
+    template <typename T, int N> LaneVec<T, N> min(const LaneVec<T, N>& a, const LaneVec<T, N>& b) { LaneVec<T, N> r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return r; }
+    template <typename T, int N> LaneVec<T, N> max(const LaneVec<T, N>& a, const LaneVec<T, N>& b) { LaneVec<T, N> r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return r; }
+   #if NGS_LANES_SSE2
+    inline LaneVec<double, 2> min(const LaneVec<double, 2>& a, const LaneVec<double, 2>& b) { return LaneVec<double, 2>::wrap(_mm_min_pd(a.v, b.v)); }
+    inline LaneVec<double, 2> max(const LaneVec<double, 2>& a, const LaneVec<double, 2>& b) { return LaneVec<double, 2>::wrap(_mm_max_pd(a.v, b.v)); }
+    inline LaneVec<float, 4> min(const LaneVec<float, 4>& a, const LaneVec<float, 4>& b) { return LaneVec<float, 4>::wrap(_mm_min_ps(a.v, b.v)); }
+    inline LaneVec<float, 4> max(const LaneVec<float, 4>& a, const LaneVec<float, 4>& b) { return LaneVec<float, 4>::wrap(_mm_max_ps(a.v, b.v)); }
+   #elif NGS_LANES_NEON
+    // minnm/maxnm return the number when one side is NaN, matching SSE with a constant bound
+    inline LaneVec<double, 2> min(const LaneVec<double, 2>& a, const LaneVec<double, 2>& b) { return LaneVec<double, 2>::wrap(vminnmq_f64(a.v, b.v)); }
+    inline LaneVec<double, 2> max(const LaneVec<double, 2>& a, const LaneVec<double, 2>& b) { return LaneVec<double, 2>::wrap(vmaxnmq_f64(a.v, b.v)); }
+    inline LaneVec<float, 4> min(const LaneVec<float, 4>& a, const LaneVec<float, 4>& b) { return LaneVec<float, 4>::wrap(vminnmq_f32(a.v, b.v)); }
+    inline LaneVec<float, 4> max(const LaneVec<float, 4>& a, const LaneVec<float, 4>& b) { return LaneVec<float, 4>::wrap(vmaxnmq_f32(a.v, b.v)); }
+   #endif
+    template <typename V> V clamp(const V& x, double lo, double hi) { return min(max(x, V((SampleOf<V>)lo)), V((SampleOf<V>)hi)); }
+
+    inline double sqrt(double x) { return std::sqrt(x); }
+    inline double round(double x) { return std::round(x); }
+    inline float sqrt(float x) { return std::sqrt(x); }
+    inline float round(float x) { return std::round(x); }
+    template <typename T, int N> LaneVec<T, N> sqrt(const LaneVec<T, N>& a) { return LaneVec<T, N>::map(a, [](T x) { return std::sqrt(x); }); }
+    template <typename T, int N> LaneVec<T, N> round(const LaneVec<T, N>& a) { return LaneVec<T, N>::map(a, [](T x) { return std::round(x); }); }
+   #if NGS_LANES_SSE2
+    inline LaneVec<double, 2> sqrt(const LaneVec<double, 2>& a) { return LaneVec<double, 2>::wrap(_mm_sqrt_pd(a.v)); }
+    inline LaneVec<float, 4> sqrt(const LaneVec<float, 4>& a) { return LaneVec<float, 4>::wrap(_mm_sqrt_ps(a.v)); }
+   #elif NGS_LANES_NEON
+    inline LaneVec<double, 2> sqrt(const LaneVec<double, 2>& a) { return LaneVec<double, 2>::wrap(vsqrtq_f64(a.v)); }
+    inline LaneVec<double, 2> round(const LaneVec<double, 2>& a) { return LaneVec<double, 2>::wrap(vrndaq_f64(a.v)); }
+    inline LaneVec<float, 4> sqrt(const LaneVec<float, 4>& a) { return LaneVec<float, 4>::wrap(vsqrtq_f32(a.v)); }
+    inline LaneVec<float, 4> round(const LaneVec<float, 4>& a) { return LaneVec<float, 4>::wrap(vrndaq_f32(a.v)); }
+   #endif
+
+    // --- Range reduction helpers ---
+    // n = round(x * scale) through the shifter; t keeps n in its low mantissa bits.
+    template <typename V>
+    V roundViaShifter(const V& x, double scale, V& n) {
+        const auto shifter = FormatOf<V>::roundShifter;
+        const V t = x * scale + shifter;
+        n = t - shifter;
+        return t;
+    }
+
+    // Integer n held in the low bits of a shifted t (two's complement, wraps)
+    template <typename V>
+    auto shiftedInteger(const V& t) { return toBits(t) - toBits(FormatOf<V>::roundShifter); }
+
+    // 2^n for an integer n held in bits
+    template <typename V, typename U>
+    V pow2(const U& n) {
+        using F = FormatOf<V>;
+        return fromBits((n + F::exponentBias) << F::mantissaBits);
+    }
+
+    // Unbiased exponent e and mantissa m in [0.5, 1) with x = m * 2^e (x > 0, normal)
+    template <typename V>
+    V splitExponent(const V& x, V& m) {
+        using F = FormatOf<V>;
+        using Bits = typename F::Bits;
+        constexpr Bits two52 = (Bits)(F::exponentBias + F::mantissaBits) << F::mantissaBits; // 2^mantissaBits
+        constexpr Bits half = (Bits)(F::exponentBias - 1) << F::mantissaBits;
+        const auto bits = toBits(x);
+        m = fromBits((bits & F::mantissaMask) | half);
+        return fromBits(((bits >> F::mantissaBits) & F::exponentMask) | two52)
+             - (fromBits(two52) + (SampleOf<V>)(F::exponentBias - 1));
+    }
+
+    // --- Transcendentals ---
+    // exp/log follow Cephes (Pade approximants after Cody-Waite reduction),
+    // sin/cos follow fdlibm. All stay within a few ulp of libm (float: of the
+    // float result) and are branch-free, so lanes evaluate in parallel.
+
+    template <typename V>
+    V exp(V x) {
+        using F = FormatOf<V>;
+        x = clamp(x, F::expMin, F::expMax);
+
+        V n;
+        const V t = roundViaShifter(x, 1.4426950408889634073599, n);
+
+        V r = x - n * F::ln2Hi;
+        r = r - n * F::ln2Lo;
+
+        const V rr = r * r;
+        const V px = r * ((1.26177193074810590878E-4 * rr + 3.02994407707441961300E-2) * rr + 9.99999999999999999910E-1);
+        const V qx = ((3.00198505138664455042E-6 * rr + 2.52448340349684104192E-3) * rr + 2.27265548208155028766E-1) * rr + 2.00000000000000000009E0;
+        const V e = 1.0 + 2.0 * (px / (qx - px));
+
+        // 2^n is built with integer lane ops only
+        return e * pow2<V>(shiftedInteger(t));
+    }
+
+    // Natural log for x > 0 (normal range)
+    template <typename V>
+    V log(const V& x) {
+        V m;
+        V e = splitExponent(x, m);
+
+        const auto low = m < V(0.70710678118654752440);
+        e = select(low, e - 1.0, e);
+        m = select(low, m + m - 1.0, m - 1.0);
+
+        const V z = m * m;
+        const V p = ((((1.01875663804580931796E-4 * m + 4.97494994976747001425E-1) * m + 4.70579119878881725854E0) * m
+                       + 1.44989225341610930846E1) * m + 1.79368678507819816313E1) * m + 7.70838733755885391666E0;
+        const V q = ((((m + 1.12873587189167450590E1) * m + 4.52279145837532221105E1) * m + 8.29875266912776603211E1) * m
+                       + 7.11544750618563894466E1) * m + 2.31251620126765340583E1;
+
+        V y = m * (z * p / q);
+        y = y - e * 2.121944400546905827679e-4;
+        y = y - 0.5 * z;
+        return (m + y) + e * 0.693359375;
+    }
+
+    // Maps sin/cos of the reduced argument back to quadrant q (integer in the low bits)
+    template <typename V, typename U>
+    void applyQuadrant(const U& quadrant, const V& sr, const V& cr, V& s, V& c) {
+        constexpr int signShift = FormatOf<V>::numBits - 2;
+
+        // Odd quadrants swap sin/cos; bit 1 of q (and of q + 1 for cos) flips the sign
+        const auto swap = (U)0 - (quadrant & 1u);
+        const V sBase = blend(swap, cr, sr);
+        const V cBase = blend(swap, sr, cr);
+        s = fromBits(toBits(sBase) ^ ((quadrant & 2u) << signShift));
+        c = fromBits(toBits(cBase) ^ (((quadrant + 1u) & 2u) << signShift));
+    }
+
+    // sin(x) and cos(x) together (quadrant reduction by pi/2)
+    template <typename V>
+    void sincos(const V& x, V& s, V& c) {
+        using F = FormatOf<V>;
+        V q;
+        const V t = roundViaShifter(x, 0.63661977236758134308, q);
+
+        V r = x - q * F::pio2Hi;
+        r = r - q * F::pio2Lo;
+
+        const V z = r * r;
+        const V sr = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04
+                     + z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+        const V cr = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05
+                     + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+
+        applyQuadrant(toBits(t), sr, cr, s, c);
+    }
+
+    // Table lookup: one load per lane (tables are double, converted to the lane type)
+    inline double gather(const double* table, std::uint64_t index) { return table[index]; }
+    inline float gather(const double* table, std::uint32_t index) { return (float)table[index]; }
+    template <typename B, int N>
+    auto gather(const double* table, const LaneVec<B, N>& index) {
+        using T = std::conditional_t<sizeof(B) == sizeof(double), double, float>;
+        B i[N];
+        T r[N];
+        index.toArray(i);
+        for (int k = 0; k < N; ++k) r[k] = (T)table[i[k]];
+        return LaneVec<T, N>::fromArray(r);
+    }
+
+    // --- Fast Tier ---
+    // Table + low-order correction. Each correction's truncation error is
+    // the same on both sides of a table cell, so the results stay continuous.
+    //   exp: rel 3.6e-11   log: abs 5.8e-11   sin/cos: abs 5e-15   (double lanes)
+    struct FastTables {
+        static constexpr int kExpSize = 64;   // 2^(j/64)
+        static constexpr int kLogSize = 128;  // mantissa cells of 1/128
+        static constexpr int kSinSize = 256;  // one turn
+
+        std::array<double, kExpSize> exp2Frac {};
+        std::array<double, kLogSize> logCentre {}, invCentre {};
+        std::array<double, kSinSize> sinTable {}, cosTable {};
+
+        FastTables() {
+            for (int j = 0; j < kExpSize; ++j) exp2Frac[(size_t)j] = std::exp2((double)j / kExpSize);
+            for (int j = 0; j < kLogSize; ++j) {
+                const double centre = 1.0 + ((double)j + 0.5) / kLogSize;
+                logCentre[(size_t)j] = std::log(centre);
+                invCentre[(size_t)j] = 1.0 / centre;
             }
-            default: out = std::tanh(x);
+            for (int j = 0; j < kSinSize; ++j) {
+                const double a = juce::MathConstants<double>::twoPi * (double)j / kSinSize;
+                sinTable[(size_t)j] = std::sin(a);
+                cosTable[(size_t)j] = std::cos(a);
             }
         }
+    };
 
-        // Post-Processing
-        if (type == 0) { // Tape
-            tapeDeemphState = (1.0 - tapeDeemphCoef) * tapeDeemphState + tapeDeemphCoef * out;
-            out = tapeDeemphState;
+    inline const FastTables fastTables;
+
+    namespace Fast {
+        template <typename V>
+        V exp(V x) {
+            using F = FormatOf<V>;
+            x = clamp(x, F::expMin, F::expMax);
+
+            // n = round(x * 64 / ln2): 2^(n / 64) = 2^(n >> 6) * table[n & 63]
+            V n;
+            const V t = roundViaShifter(x, 92.33248261689366, n);
+            const V r = (x - n * (F::ln2Hi / 64)) - n * (F::ln2Lo / 64);
+            const auto bits = shiftedInteger(t);
+
+            const V p = 1.0 + r * (1.0 + r * (0.5 + r * (1.0 / 6.0)));
+            return p * gather(fastTables.exp2Frac.data(), bits & 63u) * pow2<V>(bits >> 6);
         }
-        if (type == 11) { // Rectify
-            out = dryRect * (1.0 - character) + out * character;
+
+        template <typename V>
+        V log(const V& x) {
+            using F = FormatOf<V>;
+            V m;
+            const V e = splitExponent(x, m) - 1.0;   // m * 2 in [1, 2)
+            const auto j = (toBits(x) >> (F::mantissaBits - 7)) & 127u;
+
+            const V u = (m + m) * gather(fastTables.invCentre.data(), j) - 1.0; // |u| < 1/257
+            const V p = u * (1.0 + u * (-0.5 + u * (1.0 / 3.0)));
+            return p + gather(fastTables.logCentre.data(), j) + e * 0.69314718055994530942;
         }
 
-        out *= getMakeupGain(type);
+        template <typename V>
+        void sincos(const V& x, V& s, V& c) {
+            using F = FormatOf<V>;
+            // q = round(x * 128 / pi); sin/cos(q * pi / 128) from the table
+            V q;
+            const V t = roundViaShifter(x, 40.74366543152521, q);
+            const V r = (x - q * (F::pio2Hi / 64)) - q * (F::pio2Lo / 64);
+            const auto j = shiftedInteger(t) & 255u;
 
-        double dcOut = out - lastX_DC + dcBlockerCoef * dcBlockerState;
-        lastX_DC = out;
-        dcBlockerState = dcOut;
+            const V z = r * r;
+            const V sr = r * (1.0 - z * (1.0 / 6.0 - z * (1.0 / 120.0)));
+            const V cr = 1.0 - z * (0.5 - z * (1.0 / 24.0));
+            const V sa = gather(fastTables.sinTable.data(), j);
+            const V ca = gather(fastTables.cosTable.data(), j);
 
-        return dcOut;
+            s = sa * cr + ca * sr;
+            c = ca * cr - sa * sr;
+        }
     }
+}
 
-private:
-    double currentSampleRate = 0.0;
+// --- Math Tiers ---
+// The ADAA shapes take their transcendentals from a MathPolicy, chosen per
+// core instance: Exact (the SatMath routines above) or Fast (tables). Fast
+// additionally replaces the parameter-free pairs (tanh/logCosh,
+// langevin/intLangevin) by cubic Hermite tables of F with f as the slope.
+// That keeps F C1-continuous, so the ADAA quotient never sees a seam.
+//
+// Worst-case kernel output deviation from Exact (first-order ADAA, sine +
+// noise, 0..24 dB drive, character 0..1, 16x rate):
+//
+//   Algorithm     Fast      (output peak)
+//   AnalogTape    4.5e-9    3.7
+//   TubeTriode    1.9e-7    12
+//   Transformer   2.1e-7    2.6
+//   BJT           3.2e-7    14
+//   Diode         1.6e-8    48
+//   SoftTanh      6.2e-8    1.8
+//   Wavefold      6.9e-10   1.1e3
+//
+// The remaining algorithms are polynomial/piecewise and identical in every tier.
 
-    double dcBlockerCoef = 0.995;
-    double tapeCoefBase = 0.4;
-    double tapeDeemphCoef = 0.3;
-    double transCoef = 0.1;
-    double exciterCoef = 0.9;
+namespace MathTier {
+    enum Id : int { Exact = 0, Fast, NumTiers };
+}
 
-    double sagAttack = 0.0;
-    double sagRelease = 0.0;
+// Shape-level functions on top of a primitive set P (exp / log / sincos)
+template <typename P>
+struct ShapeMath {
+    template <typename V> static V exp(const V& x) { return P::exp(x); }
+    template <typename V> static V log(const V& x) { return P::log(x); }
+    template <typename V> static V sin(const V& x) { V s, c; P::sincos(x, s, c); return s; }
+    template <typename V> static V cos(const V& x) { V s, c; P::sincos(x, s, c); return c; }
+
+    template <typename V>
+    static V tanh(const V& x) {
+        const V t = P::exp(V(-2.0) * SatMath::abs(x));
+        return SatMath::copySign((1.0 - t) / (1.0 + t), x);
+    }
+
+    // Series below |x| = 0.25 avoid the cancellation in coth(x) - 1/x and
+    // log(sinh(x) / x); the closed forms above it never overflow.
+    template <typename V>
+    static V langevin(const V& x) {
+        const V ax = SatMath::abs(x);
+        const V x2 = x * x;
+        const V series = x * (1.0 / 3.0 + x2 * (-1.0 / 45.0 + x2 * (2.0 / 945.0 + x2 * (-1.0 / 4725.0 + x2 * (2.0 / 93555.0)))));
+        const V t = P::exp(V(-2.0) * ax);
+        const V closed = SatMath::copySign((1.0 + t) / (1.0 - t) - 1.0 / SatMath::max(ax, V(0.25)), x);
+        return SatMath::select(ax < V(0.25), series, closed);
+    }
+
+    template <typename V>
+    static V intLangevin(const V& x) {
+        const V ax = SatMath::max(SatMath::abs(x), V(0.25));
+        const V x2 = x * x;
+        const V series = x2 * (1.0 / 6.0 + x2 * (-1.0 / 180.0 + x2 * (1.0 / 2835.0 + x2 * (-1.0 / 37800.0 + x2 * (1.0 / 467775.0)))));
+        const V closed = ax - 0.69314718055994530942 + P::log((1.0 - P::exp(V(-2.0) * ax)) / ax);
+        return SatMath::select(SatMath::abs(x) < V(0.25), series, closed);
+    }
+
+    // log(cosh(x)) without overflow
+    template <typename V>
+    static V logCosh(const V& x) {
+        const V ax = SatMath::abs(x);
+        return ax - 0.69314718055994530942 + P::log(1.0 + P::exp(V(-2.0) * ax));
+    }
+};
+
+struct ExactPrimitives {
+    template <typename V> static V exp(const V& x) { return SatMath::exp(x); }
+    template <typename V> static V log(const V& x) { return SatMath::log(x); }
+    template <typename V> static void sincos(const V& x, V& s, V& c) { SatMath::sincos(x, s, c); }
+};
+
+struct FastPrimitives {
+    template <typename V> static V exp(const V& x) { return SatMath::Fast::exp(x); }
+    template <typename V> static V log(const V& x) { return SatMath::Fast::log(x); }
+    template <typename V> static void sincos(const V& x, V& s, V& c) { SatMath::Fast::sincos(x, s, c); }
+};
+
+// Even antiderivative F and its odd derivative f, tabulated over |x| < kRange
+struct HermitePairTable {
+    static constexpr int kPerUnit = 64;
+    static constexpr double kRange = 16.0;
+    static constexpr int kSize = (int)kRange * kPerUnit + 2;
+
+    std::array<double, kSize> F {}, f {};
+
+    template <typename FnF, typename Fnf>
+    HermitePairTable(FnF antiderivative, Fnf derivative) {
+        for (int i = 0; i < kSize; ++i) {
+            const double x = (double)i / kPerUnit;
+            F[(size_t)i] = antiderivative(x);
+            f[(size_t)i] = derivative(x);
+        }
+    }
+
+    // Cell index and position in the cell for |x| (clamped into the table)
+    template <typename V, typename U>
+    static V locate(const V& x, U& index) {
+        const auto shifter = SatMath::FormatOf<V>::roundShifter;
+        const V u = SatMath::min(SatMath::abs(x), V(kRange)) * (double)kPerUnit;
+        const V t = (u - 0.5) + shifter; // floor(u), a whole u lands at the end of a cell
+        index = SatMath::shiftedInteger(t);
+        return u - (t - shifter);
+    }
+
+    template <typename V>
+    V evalF(const V& x) const {
+        auto i = SatMath::toBits(x);
+        const V t = locate(x, i);
+        const double h = 1.0 / kPerUnit;
+        const V F0 = SatMath::gather(F.data(), i), F1 = SatMath::gather(F.data() + 1, i);
+        const V d0 = SatMath::gather(f.data(), i) * h, d1 = SatMath::gather(f.data() + 1, i) * h;
+        const V t2 = t * t, t3 = t2 * t;
+        return F0 * (2.0 * t3 - 3.0 * t2 + 1.0) + d0 * (t3 - 2.0 * t2 + t)
+             + F1 * (3.0 * t2 - 2.0 * t3) + d1 * (t3 - t2);
+    }
+
+    // Exact slope of evalF, with the sign of x
+    template <typename V>
+    V evalf(const V& x) const {
+        auto i = SatMath::toBits(x);
+        const V t = locate(x, i);
+        const double h = 1.0 / kPerUnit;
+        const V F0 = SatMath::gather(F.data(), i), F1 = SatMath::gather(F.data() + 1, i);
+        const V d0 = SatMath::gather(f.data(), i) * h, d1 = SatMath::gather(f.data() + 1, i) * h;
+        const V t2 = t * t;
+        const V slope = ((F1 - F0) * (6.0 * t - 6.0 * t2) + d0 * (3.0 * t2 - 4.0 * t + 1.0) + d1 * (3.0 * t2 - 2.0 * t)) * (double)kPerUnit;
+        return SatMath::copySign(slope, x);
+    }
+};
+
+inline const HermitePairTable fastTanhTable {
+    [](double x) { return ShapeMath<ExactPrimitives>::logCosh(x); },
+    [](double x) { return ShapeMath<ExactPrimitives>::tanh(x); }
+};
+inline const HermitePairTable fastLangevinTable {
+    [](double x) { return ShapeMath<ExactPrimitives>::intLangevin(x); },
+    [](double x) { return ShapeMath<ExactPrimitives>::langevin(x); }
+};
+
+// Odd second antiderivative F2 of an even F1, for ADAA2 where no closed form
+// exists. Quintic Hermite cells (F2, F1 = F2', f = F2'') keep the divided
+// differences ADAA2 takes smooth; F2 at the nodes is integrated with 8-point
+// Gauss-Legendre per cell, so the table is good to ~1e-15.
+struct QuinticAntiderivativeTable {
+    static constexpr int kPerUnit = HermitePairTable::kPerUnit;
+    static constexpr double kRange = HermitePairTable::kRange;
+    static constexpr int kSize = HermitePairTable::kSize;
+
+    std::array<double, kSize> F2 {}, F1 {}, f {};
+    double atRange = 0.0;   // F2(kRange), where the caller's asymptote takes over
 
-    double lastX = 0.0;
-    double lastF = 0.0;
-    double tapeFilterState = 0.0;
-    double tapeDeemphState = 0.0;
-    double transFilterState = 0.0;
-    double lastX_DC = 0.0;
-    double dcBlockerState = 0.0;
-
-    double sampleHoldVal = 0.0;
-    double sampleHoldCounter = 0.0;
-    double sagEnvelope = 0.0;
-};
\ No newline at end of file
+    template <typename FnF, typename Fnf>
+    QuinticAntiderivativeTable(FnF antiderivative, Fnf derivative) {
+        static constexpr double nodes[4] = { 0.1834346424956498, 0.5255324099163290, 0.7966664774136267, 0.9602898564975363 };
+        static constexpr double weights[4] = { 0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763 };
+        const double h = 1.0 / kPerUnit;
+
+        double integral = 0.0;
+        for (int i = 0; i < kSize; ++i) {
+            const double x = (double)i * h;
+            F2[(size_t)i] = integral;
+            F1[(size_t)i] = antiderivative(x);
+            f[(size_t)i] = derivative(x);
+            if (i == (int)kRange * kPerUnit) atRange = integral;
+
+            const double mid = x + 0.5 * h;
+            double cell = 0.0;
+            for (int k = 0; k < 4; ++k)
+                cell += weights[k] * (antiderivative(mid - 0.5 * h * nodes[k]) + antiderivative(mid + 0.5 * h * nodes[k]));
+            integral += 0.5 * h * cell;
+        }
+    }
+
+    template <typename V>
+    V evalF2(const V& x) const {
+        auto i = SatMath::toBits(x);
+        const V t = HermitePairTable::locate(x, i);
+        const double h = 1.0 / kPerUnit;
+        const V p0 = SatMath::gather(F2.data(), i), p1 = SatMath::gather(F2.data() + 1, i);
+        const V d0 = SatMath::gather(F1.data(), i) * h, d1 = SatMath::gather(F1.data() + 1, i) * h;
+        const V s0 = SatMath::gather(f.data(), i) * (h * h), s1 = SatMath::gather(f.data() + 1, i) * (h * h);
+        const V t2 = t * t, t3 = t2 * t, t4 = t3 * t, t5 = t4 * t;
+        const V y = p0 * (1.0 - 10.0 * t3 + 15.0 * t4 - 6.0 * t5) + d0 * (t - 6.0 * t3 + 8.0 * t4 - 3.0 * t5)
+                  + s0 * (0.5 * (t2 - 3.0 * t3 + 3.0 * t4 - t5)) + s1 * (0.5 * (t3 - 2.0 * t4 + t5))
+                  + d1 * (-4.0 * t3 + 7.0 * t4 - 3.0 * t5) + p1 * (10.0 * t3 - 15.0 * t4 + 6.0 * t5);
+        return SatMath::copySign(y, x);
+    }
+};
+
+inline const QuinticAntiderivativeTable logCoshF2Table {
+    [](double x) { return ShapeMath<ExactPrimitives>::logCosh(x); },
+    [](double x) { return ShapeMath<ExactPrimitives>::tanh(x); }
+};
+inline const QuinticAntiderivativeTable intLangevinF2Table {
+    [](double x) { return ShapeMath<ExactPrimitives>::intLangevin(x); },
+    [](double x) { return ShapeMath<ExactPrimitives>::langevin(x); }
+};
+
+// Second antiderivatives without a closed form, shared by every tier. Past
+// kRange F1 is its asymptote (|x| - ln2, minus ln|x| for Langevin) to < 1e-13
+// and is integrated analytically.
+struct SecondAntiderivative {
+    template <typename V>
+    static V intLogCosh(const V& x) {
+        const auto& table = logCoshF2Table;
+        const V ax = SatMath::abs(x);
+        const auto far = ax >= V(QuinticAntiderivativeTable::kRange);
+        const V y = table.evalF2(x);
+        if (!SatMath::any(far)) return y;
+
+        constexpr double R = QuinticAntiderivativeTable::kRange;
+        const V tail = table.atRange + 0.5 * (ax * ax - R * R) - 0.69314718055994530942 * (ax - R);
+        return SatMath::select(far, SatMath::copySign(tail, x), y);
+    }
+
+    template <typename V>
+    static V intIntLangevin(const V& x) {
+        const auto& table = intLangevinF2Table;
+        const V ax = SatMath::abs(x);
+        const auto far = ax >= V(QuinticAntiderivativeTable::kRange);
+        const V y = table.evalF2(x);
+        if (!SatMath::any(far)) return y;
+
+        constexpr double R = QuinticAntiderivativeTable::kRange;
+        const V safeX = SatMath::max(ax, V(R));
+        const V xLogX = safeX * SatMath::log(safeX) - safeX;
+        const double rLogR = R * std::log(R) - R;
+        const V tail = table.atRange + 0.5 * (ax * ax - R * R) - 0.69314718055994530942 * (ax - R) - (xLogX - rLogR);
+        return SatMath::select(far, SatMath::copySign(tail, x), y);
+    }
+};
+
+template <int Tier> struct MathPolicy;
+
+template <> struct MathPolicy<MathTier::Exact> : ShapeMath<ExactPrimitives> {};
+
+template <> struct MathPolicy<MathTier::Fast> : ShapeMath<FastPrimitives> {
+    static const HermitePairTable& tanhTable() { return fastTanhTable; }
+    static const HermitePairTable& langevinTable() { return fastLangevinTable; }
+
+    // Beyond kRange the exact forms are their asymptotes to < 1e-13
+    template <typename V> static V tanh(const V& x) {
+        const auto far = SatMath::abs(x) >= V(HermitePairTable::kRange);
+        const V y = tanhTable().evalf(x);
+        return SatMath::any(far) ? SatMath::select(far, SatMath::copySign(V(1.0), x), y) : y;
+    }
+    template <typename V> static V logCosh(const V& x) {
+        const auto far = SatMath::abs(x) >= V(HermitePairTable::kRange);
+        const V y = tanhTable().evalF(x);
+        return SatMath::any(far) ? SatMath::select(far, SatMath::abs(x) - 0.69314718055994530942, y) : y;
+    }
+    template <typename V> static V langevin(const V& x) {
+        const V ax = SatMath::abs(x);
+        const auto far = ax >= V(HermitePairTable::kRange);
+        const V y = langevinTable().evalf(x);
+        return SatMath::any(far) ? SatMath::select(far, SatMath::copySign(1.0 - 1.0 / ax, x), y) : y;
+    }
+    template <typename V> static V intLangevin(const V& x) {
+        const V ax = SatMath::abs(x);
+        const auto far = ax >= V(HermitePairTable::kRange);
+        const V y = langevinTable().evalF(x);
+        return SatMath::any(far) ? SatMath::select(far, ax - 0.69314718055994530942 - SatMath::Fast::log(SatMath::max(ax, V(1.0))), y) : y;
+    }
+};
+
+
+// ==============================================================================
+// 3. Saturation Kernels (Release Candidate v2)
+// ==============================================================================
+//
+// Every algorithm is compiled into its own SaturationKernel<Algo>, which only
+// contains the pre/post stages and ADAA pair that algorithm actually uses.
+// SaturationCore picks the kernel once per block through a dispatch table, so
+// the per-sample loop never branches on the algorithm id. Kernels are written
+// against a value type V (double, or LaneVec for several channels at once).
+
+namespace SatAlgo {
+    enum Id : int {
+        AnalogTape = 0, TubeTriode, TubePentode, Transformer, Console,
+        JFET, BJT, Diode,
+        SoftTanh, HardClip, Wavefold, Rectify, Bitcrush, Exciter,
+        NumAlgorithms
+    };
+}
+
+// Antiderivative anti-aliasing order of the ADAA algorithms. First costs half
+// a sample of group delay at the DSP rate, Second a whole sample but rolls the
+// aliases off at 12 dB/oct instead of 6.
+namespace AdaaOrder {
+    enum Id : int { First = 0, Second, NumOrders };
+}
+
+// Rate-dependent coefficients shared by all channels
+struct SaturationCoeffs {
+    double dcBlockerCoef = 0.995;
+    double tapeCoefBase = 0.4;
+    double tapeDeemphCoef = 0.3;
+    double transCoef = 0.1;
+    double exciterCoef = 0.9;
+
+    double sagAttack = 0.0;
+    double sagRelease = 0.0;
+
+    void prepare(double sampleRate) {
+        dcBlockerCoef = 1.0 - (220.0 / sampleRate);
+
+        double ratio = sampleRate / 44100.0;
+        tapeCoefBase = 1.0 / ratio;
+        tapeDeemphCoef = 0.3 / ratio;
+
+        transCoef = 0.1 / ratio;
+        exciterCoef = std::pow(0.9, 1.0 / ratio);
+
+        sagAttack = 1.0 - std::exp(-1.0 / (0.02 * sampleRate));
+        sagRelease = 1.0 - std::exp(-1.0 / (0.10 * sampleRate));
+    }
+};
+
+// Per-channel state (one lane per channel when V is a LaneVec)
+template <typename V>
+struct SaturationState {
+    V lastX = 0.0;
+    V lastF = 0.0;         // F(lastX), or F2(lastX) under ADAA2
+    V lastX2 = 0.0;        // ADAA2: x[n-2]
+    V lastD = 0.0;         // ADAA2: divided difference of F2 over (x[n-2], x[n-1])
+    bool reanchor = false; // lastF/lastD belong to another order
+    V tapeFilterState = 0.0;
+    V tapeDeemphState = 0.0;
+    V transFilterState = 0.0;
+    V lastX_DC = 0.0;
+    V dcBlockerState = 0.0;
+
+    V sampleHoldVal = 0.0;
+    V sampleHoldCounter = 0.0;
+    V sagEnvelope = 0.0;
+};
+
+// --- Parameter Ramps ---
+// The kernels refresh their coefficients once per kRampSegment samples
+// while a ramp is active (see ValueRamp in section 1).
+struct ParamRamp {
+    ValueRamp driveDB;
+    ValueRamp character;
+
+    bool isConstant() const { return driveDB.isConstant() && character.isConstant(); }
+};
+
+// --- ADAA Pairs ---
+// f(x) is the waveshaper, F(x) its first and F2(x) its second antiderivative
+// (F2' = F, used by second-order ADAA). Params holds
+// everything the algorithm derives from `character`, so it can be hoisted
+// out of the sample loop. makeupGain is the static output compensation.
+// Transcendentals come from the MathPolicy M the kernel was built with.
+template <int Algo> struct SaturationShape;
+
+template <> struct SaturationShape<SatAlgo::AnalogTape> { // Normalized 3x
+    static constexpr double makeupGain = 1.0;
+    struct Params { double tapeCoef; };
+    static Params makeParams(double character, const SaturationCoeffs& c) { return { (0.05 + 0.55 * character) * c.tapeCoefBase }; }
+    template <typename M, typename V> static V f(const V& x, const Params&) { return 3.0 * M::langevin(x); }
+    template <typename M, typename V> static V F(const V& x, const Params&) { return 3.0 * M::intLangevin(x); }
+    template <typename M, typename V> static V F2(const V& x, const Params&) { return 3.0 * SecondAntiderivative::intIntLangevin(x); }
+};
+
+template <> struct SaturationShape<SatAlgo::TubeTriode> { // Normalized
+    static constexpr double makeupGain = 1.0;
+    struct Params { double k, invK, invK2, invK3; };
+    static Params makeParams(double character, const SaturationCoeffs&) {
+        double k = 0.5 + character * 1.5;
+        return { k, 1.0 / k, 1.0 / (k * k), 1.0 / (k * k * k) };
+    }
+    template <typename M, typename V> static V f(const V& x, const Params& p) { return SatMath::select(x > V(0.0), x / (1.0 + p.k * x), x); }
+    template <typename M, typename V> static V F(const V& x, const Params& p) {
+        const V xp = SatMath::max(x, V(0.0));
+        return SatMath::select(x > V(0.0), (x * p.invK) - (M::log(1.0 + p.k * xp) * p.invK2), 0.5 * x * x);
+    }
+    // Int Int y (pos) = x^2/2k - ((1 + kx) ln(1 + kx) - kx) / k^3
+    template <typename M, typename V> static V F2(const V& x, const Params& p) {
+        const V xp = SatMath::max(x, V(0.0));
+        const V u = 1.0 + p.k * xp;
+        return SatMath::select(x > V(0.0), (0.5 * x * x * p.invK) - ((u * M::log(u) - p.k * xp) * p.invK3), x * x * x / 6.0);
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::TubePentode> {
+    static constexpr double makeupGain = 1.2;
+    struct Params {};
+    static Params makeParams(double, const SaturationCoeffs&) { return {}; }
+    template <typename M, typename V> static V f(const V& x, const Params&) { return x - (x * x * x / 3.0); }
+    template <typename M, typename V> static V F(const V& x, const Params&) { return (0.5 * x * x) - (x * x * x * x * 0.08333333); }
+    template <typename M, typename V> static V F2(const V& x, const Params&) { return (x * x * x / 6.0) - (x * x * x * x * x * 0.016666666); }
+};
+
+template <> struct SaturationShape<SatAlgo::Transformer> {
+    static constexpr double makeupGain = 1.1;
+    struct Params { double b, invB, invB2, invB3, lowBoost; };
+    static Params makeParams(double character, const SaturationCoeffs&) {
+        double b = 0.5 + character * 0.5;
+        return { b, 1.0 / b, 1.0 / (b * b), 1.0 / (b * b * b), character * 2.0 };
+    }
+    template <typename M, typename V> static V f(const V& x, const Params& p) { return x / (1.0 + p.b * SatMath::abs(x)); }
+    template <typename M, typename V> static V F(const V& x, const Params& p) {
+        const V absX = SatMath::abs(x);
+        return SatMath::select(absX < V(1.0e-5), x * x / 2.0, (absX * p.invB) - (M::log(1.0 + p.b * absX) * p.invB2));
+    }
+    template <typename M, typename V> static V F2(const V& x, const Params& p) {
+        const V absX = SatMath::abs(x);
+        const V u = 1.0 + p.b * absX;
+        const V odd = (0.5 * absX * absX * p.invB) - ((u * M::log(u) - p.b * absX) * p.invB3);
+        return SatMath::select(absX < V(1.0e-5), x * x * x / 6.0, SatMath::copySign(odd, x));
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::Console> {
+    static constexpr double makeupGain = 1.0;
+    struct Params {};
+    static Params makeParams(double, const SaturationCoeffs&) { return {}; }
+    template <typename M, typename V> static V f(const V& x, const Params&) { return x / SatMath::sqrt(1.0 + x * x); }
+    template <typename M, typename V> static V F(const V& x, const Params&) { return SatMath::sqrt(1.0 + x * x); }
+    // Int sqrt(1 + x^2) = (x sqrt(1 + x^2) + asinh x) / 2
+    template <typename M, typename V> static V F2(const V& x, const Params&) {
+        const V r = SatMath::sqrt(1.0 + x * x);
+        const V asinh = SatMath::copySign(M::log(SatMath::abs(x) + r), x);
+        return 0.5 * (x * r + asinh);
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::JFET> {
+    static constexpr double makeupGain = 1.4;
+    struct Params { double a; };
+    static Params makeParams(double character, const SaturationCoeffs&) { return { 0.2 + character * 0.3 }; }
+    template <typename M, typename V> static V f(const V& x, const Params& p) { return x - p.a * x * x; }
+    template <typename M, typename V> static V F(const V& x, const Params& p) { return (0.5 * x * x) - (p.a * x * x * x / 3.0); }
+    template <typename M, typename V> static V F2(const V& x, const Params& p) { return (x * x * x / 6.0) - (p.a * x * x * x * x / 12.0); }
+};
+
+template <> struct SaturationShape<SatAlgo::BJT> { // Refined: Linear at 0
+    static constexpr double makeupGain = 1.0; // Unity at 0dB
+    struct Params { double k, invK, invK2, invK3; };
+    static Params makeParams(double character, const SaturationCoeffs&) {
+        double k = 0.1 + character * 5.0;
+        return { k, 1.0 / k, 1.0 / (k * k), 1.0 / (k * k * k) };
+    }
+    template <typename M, typename V> static V f(const V& x, const Params& p) {
+        const V e = M::exp(-p.k * SatMath::max(x, V(0.0)));
+        return SatMath::select(x > V(0.0), (1.0 - e) * p.invK, x);
+    }
+    // Int y (pos) = x/k + exp(-kx)/k^2 - 1/k^2 (Constant adjusted for continuity at 0)
+    // Int y (neg) = 0.5 * x * x
+    template <typename M, typename V> static V F(const V& x, const Params& p) {
+        const V e = M::exp(-p.k * SatMath::max(x, V(0.0)));
+        return SatMath::select(x > V(0.0), (x * p.invK) + (e * p.invK2) - p.invK2, 0.5 * x * x);
+    }
+    // Int Int y (pos) = x^2/2k - x/k^2 + (1 - exp(-kx))/k^3
+    template <typename M, typename V> static V F2(const V& x, const Params& p) {
+        const V e = M::exp(-p.k * SatMath::max(x, V(0.0)));
+        return SatMath::select(x > V(0.0), (0.5 * x * x * p.invK) - (x * p.invK2) + ((1.0 - e) * p.invK3), x * x * x / 6.0);
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::Diode> { // Normalized
+    static constexpr double makeupGain = 1.0;
+    struct Params { double k, invK, invK3; };
+    static Params makeParams(double character, const SaturationCoeffs&) {
+        double k = 1.5 + character * 3.0;
+        return { k, 1.0 / k, 1.0 / (k * k * k) };
+    }
+    // Odd-symmetric: sign(x) * (1 - exp(-k|x|)) / k
+    template <typename M, typename V> static V f(const V& x, const Params& p) {
+        return SatMath::copySign((1.0 - M::exp(-p.k * SatMath::abs(x))) * p.invK, x);
+    }
+    template <typename M, typename V> static V F(const V& x, const Params& p) {
+        const V absX = SatMath::abs(x);
+        return (absX + M::exp(-p.k * absX) * p.invK) * p.invK;
+    }
+    // Odd: sign(x) * (x^2/2k + (1 - exp(-k|x|))/k^3)
+    template <typename M, typename V> static V F2(const V& x, const Params& p) {
+        const V absX = SatMath::abs(x);
+        return SatMath::copySign((0.5 * absX * absX * p.invK) + ((1.0 - M::exp(-p.k * absX)) * p.invK3), x);
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::SoftTanh> {
+    static constexpr double makeupGain = 1.0;
+    struct Params { double bias; };
+    static Params makeParams(double character, const SaturationCoeffs&) { return { character > 0.0 ? character * 0.5 : 0.0 }; }
+    template <typename M, typename V> static V f(const V& x, const Params&) { return M::tanh(x); }
+    template <typename M, typename V> static V F(const V& x, const Params&) { return M::logCosh(x); }
+    template <typename M, typename V> static V F2(const V& x, const Params&) { return SecondAntiderivative::intLogCosh(x); }
+};
+
+template <> struct SaturationShape<SatAlgo::HardClip> {
+    static constexpr double makeupGain = 1.0;
+    struct Params {};
+    static Params makeParams(double, const SaturationCoeffs&) { return {}; }
+    template <typename M, typename V> static V f(const V& x, const Params&) { return SatMath::clamp(x, -1.0, 1.0); }
+    template <typename M, typename V> static V F(const V& x, const Params&) {
+        return SatMath::select(SatMath::abs(x) > V(1.0), SatMath::abs(x) - 0.5, 0.5 * x * x);
+    }
+    template <typename M, typename V> static V F2(const V& x, const Params&) {
+        const V absX = SatMath::abs(x);
+        return SatMath::select(absX > V(1.0), SatMath::copySign(0.5 * absX * absX - 0.5 * absX + (1.0 / 6.0), x), x * x * x / 6.0);
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::Wavefold> { // Refined Range
+    static constexpr double makeupGain = 3.2; // Compensate for 0.2x input scaling
+    struct Params { double w, invW, invW2; };
+    static Params makeParams(double character, const SaturationCoeffs&) {
+        double w = (0.5 + character * 2.5) * juce::MathConstants<double>::pi; // Range 0.5pi to 3.0pi
+        return { w, 1.0 / w, 1.0 / (w * w) };
+    }
+    template <typename M, typename V> static V f(const V& x, const Params& p) { return M::sin(x * p.w); }
+    template <typename M, typename V> static V F(const V& x, const Params& p) { return -M::cos(x * p.w) * p.invW; }
+    template <typename M, typename V> static V F2(const V& x, const Params& p) { return -M::sin(x * p.w) * p.invW2; }
+};
+
+template <> struct SaturationShape<SatAlgo::Rectify> {
+    static constexpr double makeupGain = 1.0;
+    struct Params { double mix; };
+    static Params makeParams(double character, const SaturationCoeffs&) { return { character }; }
+    template <typename M, typename V> static V f(const V& x, const Params&) { return SatMath::abs(x); }
+    template <typename M, typename V> static V F(const V& x, const Params&) { return 0.5 * x * SatMath::abs(x); }
+    template <typename M, typename V> static V F2(const V& x, const Params&) { return x * x * SatMath::abs(x) / 6.0; }
+};
+
+// Bitcrush and Exciter are stateful and bypass ADAA
+template <> struct SaturationShape<SatAlgo::Bitcrush> {
+    static constexpr double makeupGain = 1.0;
+    struct Params { double rateDiv, steps, invSteps; };
+    static Params makeParams(double character, const SaturationCoeffs&) {
+        double bits = 16.0 - (character * 14.0);
+        if (bits < 1.0) bits = 1.0;
+        double steps = std::pow(2.0, bits);
+        return { 1.0 + (character * 49.0), steps, 1.0 / steps };
+    }
+};
+
+template <> struct SaturationShape<SatAlgo::Exciter> {
+    static constexpr double makeupGain = 1.0;
+    struct Params { double amount; };
+    static Params makeParams(double character, const SaturationCoeffs&) { return { character * 2.0 }; }
+};
+
+// --- Kernel ---
+template <int Algo, typename V, int Tier = MathTier::Exact, int Order = AdaaOrder::First>
+struct SaturationKernel {
+    using Shape = SaturationShape<Algo>;
+    using M = MathPolicy<Tier>;
+    using Params = typename Shape::Params;
+    using State = SaturationState<V>;
+
+    static constexpr bool hasSag = (Algo <= SatAlgo::BJT);
+    static constexpr bool useADAA = (Algo <= SatAlgo::Rectify);
+    static constexpr bool useADAA2 = useADAA && Order == AdaaOrder::Second;
+
+    // Character-derived coefficients are refreshed every kRampSegment samples
+    // while `character` is ramping. Drive follows its ramp per sample.
+    static constexpr int kRampSegment = 16;
+
+    // Below this |dx| the ADAA quotient falls back to f at the midpoint. F's
+    // rounding error is divided by dx, so float lanes need a wider threshold.
+    static constexpr double kIllConditioned = std::is_same_v<SatMath::SampleOf<V>, float> ? 1.0e-2 : 1.0e-6;
+
+    // ADAA2 divides F2's rounding error by two differences, so its fallbacks
+    // engage earlier: F2 grows with x^2 where F grows with |x|.
+    static constexpr double kIllConditioned2 = std::is_same_v<SatMath::SampleOf<V>, float> ? 3.0e-2 : 1.0e-5;
+
+    // (F2(a) - F2(b)) / (a - b), or F at the midpoint when a ~ b
+    static inline V dividedF2(const V& a, const V& b, const V& F2a, const V& F2b, const Params& p) {
+        const V d = a - b;
+        const auto illConditioned = SatMath::abs(d) < V(kIllConditioned2);
+        V q = (F2a - F2b) / SatMath::select(illConditioned, V(1.0), d);
+        if (SatMath::any(illConditioned))
+            q = SatMath::select(illConditioned, Shape::template F<M>(0.5 * (a + b), p), q);
+        return q;
+    }
+
+    // Second-order ADAA: 2 / (x0 - x2) * (D(x0, x1) - D(x1, x2)). When x0 ~ x2
+    // the expansion around their midpoint is used, and f itself once all
+    // three samples meet.
+    static inline V adaa2(State& s, const Params& p, const V& x) {
+        const V F2x = Shape::template F2<M>(x, p);
+        const V D = dividedF2(x, s.lastX, F2x, s.lastF, p);
+        const V dx2 = x - s.lastX2;
+        const auto illConditioned = SatMath::abs(dx2) < V(kIllConditioned2);
+        V out = 2.0 * (D - s.lastD) / SatMath::select(illConditioned, V(1.0), dx2);
+
+        if (SatMath::any(illConditioned)) {
+            const V xBar = 0.5 * (x + s.lastX2);
+            const V delta = xBar - s.lastX;
+            const auto flat = SatMath::abs(delta) < V(kIllConditioned2);
+            const V safeDelta = SatMath::select(flat, V(1.0), delta);
+            const V curved = (2.0 / safeDelta) * (Shape::template F<M>(xBar, p) + (s.lastF - Shape::template F2<M>(xBar, p)) / safeDelta);
+            const V fallback = SatMath::select(flat, Shape::template f<M>(0.5 * (xBar + s.lastX), p), curved);
+            out = SatMath::select(illConditioned, fallback, out);
+        }
+
+        s.lastX2 = s.lastX;
+        s.lastX = x;
+        s.lastF = F2x;
+        s.lastD = D;
+        return out;
+    }
+
+    static inline V quantise(const V& x, const Params& p) {
+        return SatMath::round(x * p.steps) * p.invSteps;
+    }
+
+    // x plus the soft-knee-distorted high band
+    static inline V excite(const V& x, const V& hpf, const Params& p) {
+        const double k = 0.5;
+        const V drivenHPF = hpf * 1.5;
+        const V dist = SatMath::select(drivenHPF > V(0.0), drivenHPF / (1.0 + k * SatMath::max(drivenHPF, V(0.0))), drivenHPF);
+        return x + p.amount * dist;
+    }
+
+    static inline V tick(State& s, const SaturationCoeffs& c, const Params& p, const V& in, double drive, double sagAmount) {
+        // 1. Dynamic Bias (Sag)
+        V x = in * drive;
+        if constexpr (hasSag) {
+            const V inputPower = SatMath::abs(in);
+            const V coef = SatMath::select(inputPower > s.sagEnvelope, V(c.sagAttack), V(c.sagRelease));
+            s.sagEnvelope += coef * (inputPower - s.sagEnvelope);
+
+            x *= 1.0 - (s.sagEnvelope * (0.15 * sagAmount));
+        }
+        juce::ignoreUnused(sagAmount);
+
+        // Pre-Processing
+        if constexpr (Algo == SatAlgo::AnalogTape) {
+            const V w = x - p.tapeCoef * s.tapeFilterState;
+            s.tapeFilterState = w;
+            x = w + p.tapeCoef * x;
+        }
+        if constexpr (Algo == SatAlgo::Transformer) {
+            s.transFilterState += c.transCoef * (x - s.transFilterState);
+            x = x + s.transFilterState * p.lowBoost;
+        }
+        if constexpr (Algo == SatAlgo::SoftTanh) {
+            x += p.bias;
+        }
+
+        [[maybe_unused]] const V dryRect = x;
+
+        // Input Scaling for Wavefold
+        if constexpr (Algo == SatAlgo::Wavefold) x *= 0.2; // Wavefold Tame
+
+        // Core Saturation
+        V out = 0.0;
+
+        if constexpr (useADAA2) {
+            out = adaa2(s, p, x);
+        }
+        else if constexpr (useADAA) {
+            const V Fx = Shape::template F<M>(x, p);
+            const V dx = x - s.lastX;
+            const auto illConditioned = SatMath::abs(dx) < V(kIllConditioned);
+            out = (Fx - s.lastF) / SatMath::select(illConditioned, V(1.0), dx);
+            if (SatMath::any(illConditioned))
+                out = SatMath::select(illConditioned, Shape::template f<M>(0.5 * (x + s.lastX), p), out);
+            s.lastX = x;
+            s.lastF = Fx;
+        }
+        else if constexpr (Algo == SatAlgo::Bitcrush) {
+            s.sampleHoldCounter += 1.0;
+            const auto hold = s.sampleHoldCounter >= V(p.rateDiv);
+            s.sampleHoldCounter = SatMath::select(hold, V(0.0), s.sampleHoldCounter);
+            s.sampleHoldVal = SatMath::select(hold, x, s.sampleHoldVal);
+            out = quantise(s.sampleHoldVal, p);
+        }
+        else if constexpr (Algo == SatAlgo::Exciter) {
+            out = excite(x, x - c.exciterCoef * s.lastX, p);
+        }
+
+        // Post-Processing
+        if constexpr (Algo == SatAlgo::AnalogTape) {
+            s.tapeDeemphState = (1.0 - c.tapeDeemphCoef) * s.tapeDeemphState + c.tapeDeemphCoef * out;
+            out = s.tapeDeemphState;
+        }
+        if constexpr (Algo == SatAlgo::Rectify) {
+            out = dryRect * (1.0 - p.mix) + out * p.mix;
+        }
+
+        out *= Shape::makeupGain;
+
+        const V dcOut = out - s.lastX_DC + c.dcBlockerCoef * s.dcBlockerState;
+        s.lastX_DC = out;
+        s.dcBlockerState = dcOut;
+
+        return dcOut;
+    }
+
+    // --- Static Transfer Curve ---
+    // The memoryless part of tick(): drive, the static pre-shaping, f (what
+    // the ADAA quotient converges to for a slowly moving input), the Rectify
+    // blend and the Bitcrush quantiser, with the makeup gain. Sag, the
+    // tape/transformer emphasis, sample-and-hold and the DC blocker are left
+    // out; the Exciter curve is what content above its high-pass sees.
+    static inline V transfer(const Params& p, const V& in, double drive) {
+        V x = in * drive;
+        if constexpr (Algo == SatAlgo::SoftTanh) x += p.bias;
+
+        [[maybe_unused]] const V dryRect = x;
+        if constexpr (Algo == SatAlgo::Wavefold) x *= 0.2;
+
+        V out = 0.0;
+        if constexpr (useADAA) out = Shape::template f<M>(x, p);
+        else if constexpr (Algo == SatAlgo::Bitcrush) out = quantise(x, p);
+        else if constexpr (Algo == SatAlgo::Exciter) out = excite(x, x, p);
+
+        if constexpr (Algo == SatAlgo::Rectify) out = dryRect * (1.0 - p.mix) + out * p.mix;
+        return out * Shape::makeupGain;
+    }
+
+    static void evaluateCurve(const SaturationCoeffs& c, double driveDB, double character, const V* x, V* y, int n) {
+        const Params p = Shape::makeParams(character, c);
+        const double drive = std::pow(10.0, driveDB / 20.0);
+        for (int i = 0; i < n; ++i) y[i] = transfer(p, x[i], drive);
+    }
+
+    // Re-anchor the antiderivative to new coefficients (or the other order's
+    // history) so the ADAA difference quotient does not see a step in F.
+    static void reanchor(State& s, const Params& p) {
+        if constexpr (useADAA2) {
+            s.lastF = Shape::template F2<M>(s.lastX, p);
+            s.lastD = dividedF2(s.lastX, s.lastX2, s.lastF, Shape::template F2<M>(s.lastX2, p), p);
+        }
+        else if constexpr (useADAA) {
+            s.lastF = Shape::template F<M>(s.lastX, p);
+        }
+        juce::ignoreUnused(s, p);
+    }
+
+    static void processBlock(State& s, const SaturationCoeffs& c, const V* in, V* out, int n, const ParamRamp& ramp) {
+        if (n <= 0) return;
+
+        if (ramp.isConstant()) {
+            processStatic(s, c, in, out, n, ramp.driveDB.start, ramp.character.start);
+            return;
+        }
+
+        const double invN = 1.0 / (double)n;
+        const double driveStepDB = (ramp.driveDB.end - ramp.driveDB.start) * invN;
+        const double charStep = (ramp.character.end - ramp.character.start) * invN;
+
+        double driveDB = ramp.driveDB.start;
+        double drive = std::pow(10.0, driveDB / 20.0);
+        const double driveRatio = ramp.driveDB.isConstant() ? 1.0 : std::pow(10.0, driveStepDB / 20.0);
+
+        const int segmentLength = ramp.character.isConstant() ? n : kRampSegment;
+
+        for (int seg = 0; seg < n; seg += segmentLength) {
+            const int segEnd = std::min(n, seg + segmentLength);
+            const Params p = Shape::makeParams(ramp.character.start + charStep * seg, c);
+
+            if (std::exchange(s.reanchor, false) || seg > 0) reanchor(s, p);
+
+            for (int i = seg; i < segEnd; ++i) {
+                double sagAmount = 0.0;
+                if constexpr (hasSag) sagAmount = juce::jlimit(0.0, 1.0, driveDB / 12.0);
+
+                out[i] = tick(s, c, p, in[i], drive, sagAmount);
+
+                driveDB += driveStepDB;
+                drive *= driveRatio;
+            }
+        }
+    }
+
+    // Settled parameters: coefficients, drive and sag depth are loop invariants
+    static void processStatic(State& s, const SaturationCoeffs& c, const V* in, V* out, int n, double driveDB, double character) {
+        const Params p = Shape::makeParams(character, c);
+        const double drive = std::pow(10.0, driveDB / 20.0);
+        const double sagAmount = hasSag ? juce::jlimit(0.0, 1.0, driveDB / 12.0) : 0.0;
+
+        if (std::exchange(s.reanchor, false)) reanchor(s, p);
+
+        for (int i = 0; i < n; ++i)
+            out[i] = tick(s, c, p, in[i], drive, sagAmount);
+    }
+};
+
+// ==============================================================================
+// 4. Saturation Core
+// ==============================================================================
+//
+// LaneSaturationCore<double> processes one channel; LaneSaturationCore with a
+// LaneVec runs one channel per lane through the same kernels in one pass.
+
+template <typename V>
+class LaneSaturationCore {
+public:
+    using Value = V;
+    using State = SaturationState<V>;
+    using KernelFn = void (*)(State&, const SaturationCoeffs&, const V*, V*, int, const ParamRamp&);
+
+    static constexpr int numLanes = LaneTraits<V>::numLanes;
+
+    void prepare(double sampleRate) {
+        if (currentSampleRate == sampleRate) return;
+        currentSampleRate = sampleRate;
+        coeffs.prepare(sampleRate);
+    }
+
+    void reset() { state = {}; }
+
+    // Selects the kernel for the following blocks. Call once per block.
+    void setAlgorithm(int type) {
+        algorithm = juce::jlimit(0, (int)SatAlgo::NumAlgorithms - 1, type);
+        kernel = getKernelTable()[(size_t)adaaOrder][(size_t)mathTier][(size_t)algorithm];
+    }
+
+    // Accuracy tier of the ADAA transcendentals (MathTier::Id)
+    void setMathTier(int tier) {
+        mathTier = juce::jlimit(0, (int)MathTier::NumTiers - 1, tier);
+        kernel = getKernelTable()[(size_t)adaaOrder][(size_t)mathTier][(size_t)algorithm];
+    }
+
+    // Anti-aliasing order (AdaaOrder::Id). The other order's history is
+    // re-anchored on the next block instead of being cleared.
+    void setAdaaOrder(int order) {
+        order = juce::jlimit(0, (int)AdaaOrder::NumOrders - 1, order);
+        if (order == adaaOrder) return;
+        adaaOrder = order;
+        state.lastX2 = state.lastX;
+        state.reanchor = true;
+        kernel = getKernelTable()[(size_t)adaaOrder][(size_t)mathTier][(size_t)algorithm];
+    }
+
+    int getAdaaOrder() const { return adaaOrder; }
+
+    // --- Main Process ---
+    // `in` and `out` may alias. drive/character ramp linearly across the n samples.
+    void processBlock(const V* in, V* out, int n, const ParamRamp& ramp) {
+        kernel(state, coeffs, in, out, n, ramp);
+    }
+
+    using KernelRow = std::array<KernelFn, SatAlgo::NumAlgorithms>;
+    using KernelTierTable = std::array<KernelRow, MathTier::NumTiers>;
+
+    // [order][tier][algorithm]
+    static const std::array<KernelTierTable, AdaaOrder::NumOrders>& getKernelTable() {
+        static const std::array<KernelTierTable, AdaaOrder::NumOrders> table = {
+            makeKernelTiers<AdaaOrder::First>(),
+            makeKernelTiers<AdaaOrder::Second>()
+        };
+        return table;
+    }
+
+private:
+    template <int Order>
+    static KernelTierTable makeKernelTiers() {
+        return {
+            makeKernelRow<MathTier::Exact, Order>(std::make_integer_sequence<int, SatAlgo::NumAlgorithms>{}),
+            makeKernelRow<MathTier::Fast, Order>(std::make_integer_sequence<int, SatAlgo::NumAlgorithms>{})
+        };
+    }
+
+    template <int Tier, int Order, int... Algos>
+    static KernelRow makeKernelRow(std::integer_sequence<int, Algos...>) {
+        return { { &SaturationKernel<Algos, V, Tier, Order>::processBlock... } };
+    }
+
+    double currentSampleRate = 0.0;
+    SaturationCoeffs coeffs;
+    State state;
+    int algorithm = SatAlgo::AnalogTape;
+    int mathTier = MathTier::Exact;
+    int adaaOrder = AdaaOrder::First;
+    KernelFn kernel = &SaturationKernel<SatAlgo::AnalogTape, V>::processBlock;
+};
+
+using SaturationCore = LaneSaturationCore<double>;
+
+// --- Transfer Curve ---
+// Stateless batch evaluation of an algorithm's static curve (see
+// SaturationKernel::transfer) through the same shapes, parameters and math
+// tiers as the realtime kernels, two points per lane pass. For the curve
+// display, tooling and kernel comparisons. x and y may alias.
+namespace TransferCurve {
+    using Vector = LaneVec<double, 2>;
+    using Fn = void (*)(const SaturationCoeffs&, double, double, const Vector*, Vector*, int);
+    using Row = std::array<Fn, SatAlgo::NumAlgorithms>;
+
+    template <int Tier, int... Algos>
+    Row makeRow(std::integer_sequence<int, Algos...>) {
+        return { { &SaturationKernel<Algos, Vector, Tier>::evaluateCurve... } };
+    }
+
+    // [tier][algorithm]
+    inline const std::array<Row, MathTier::NumTiers>& getTable() {
+        static const std::array<Row, MathTier::NumTiers> table = {
+            makeRow<MathTier::Exact>(std::make_integer_sequence<int, SatAlgo::NumAlgorithms>{}),
+            makeRow<MathTier::Fast>(std::make_integer_sequence<int, SatAlgo::NumAlgorithms>{})
+        };
+        return table;
+    }
+}
+
+inline void evaluateCurve(int type, double driveDB, double character, const double* x, double* y, int n, int tier = MathTier::Exact) {
+    using V = TransferCurve::Vector;
+    constexpr int chunk = 64;
+
+    // The static curve uses none of the rate-dependent coefficients
+    const SaturationCoeffs coeffs;
+    const auto fn = TransferCurve::getTable()[(size_t)juce::jlimit(0, (int)MathTier::NumTiers - 1, tier)]
+                                             [(size_t)juce::jlimit(0, (int)SatAlgo::NumAlgorithms - 1, type)];
+
+    V in[chunk], out[chunk];
+    double lanes[V::numLanes];
+    for (int start = 0; start < n; start += chunk * V::numLanes) {
+        const int count = std::min(n - start, chunk * V::numLanes);
+        const int numVectors = (count + V::numLanes - 1) / V::numLanes;
+        for (int v = 0; v < numVectors; ++v) {
+            for (int k = 0; k < V::numLanes; ++k) {
+                const int i = v * V::numLanes + k;
+                lanes[k] = i < count ? x[start + i] : 0.0;
+            }
+            in[v] = V::fromArray(lanes);
+        }
+
+        fn(coeffs, driveDB, character, in, out, numVectors);
+
+        for (int v = 0; v < numVectors; ++v) {
+            out[v].toArray(lanes);
+            for (int k = 0; k < V::numLanes; ++k) {
+                const int i = v * V::numLanes + k;
+                if (i < count) y[start + i] = lanes[k];
+            }
+        }
+    }
+}
+
+// --- DSP Precision ---
+// DspVector fills one 128-bit register: double2 or float4.
+using DspSample = std::conditional_t<NGS_DSP_FLOAT != 0, float, double>;
+using DspVector = LaneVec<DspSample, (int)(16 / sizeof(DspSample))>;
+
+// --- Channel Groups ---
+// Any number of channels runs DspVector::numLanes at a time. Lane k of every
+// filter and saturation state belongs to channel (first + k) of the group, so
+// the per-channel state is a structure of arrays and one pass serves them all.
+using ChannelVector = DspVector;
+using ChannelSaturationCore = LaneSaturationCore<ChannelVector>;
+using ChannelFilter = BasicHighPrecisionFilter<ChannelVector>;
+using ChannelCrossover = BasicLinkwitzRileyCrossover<ChannelVector>;
+
+inline int numChannelGroups(int numChannels) {
+    return (numChannels + ChannelVector::numLanes - 1) / ChannelVector::numLanes;
+}
+
+// Interleaves channels [first, first + numLanes) of planar buffers into lanes.
+// Channels past numChannels read as silence.
+template <typename T>
+void packChannelGroup(const T* const* channels, int numChannels, int first, ChannelVector* dst, int numSamples) {
+    constexpr int L = ChannelVector::numLanes;
+    const int count = std::min(L, numChannels - first);
+    DspSample x[L] = {};
+    for (int i = 0; i < numSamples; ++i) {
+        for (int k = 0; k < count; ++k) x[k] = (DspSample)channels[first + k][i];
+        dst[i] = ChannelVector::fromArray(x);
+    }
+}
+
+template <typename T>
+void unpackChannelGroup(const ChannelVector* src, T* const* channels, int numChannels, int first, int numSamples) {
+    constexpr int L = ChannelVector::numLanes;
+    const int count = std::min(L, numChannels - first);
+    DspSample x[L];
+    for (int i = 0; i < numSamples; ++i) {
+        src[i].toArray(x);
+        for (int k = 0; k < count; ++k) channels[first + k][i] = (T)x[k];
+    }
+}
+
+// ==============================================================================
+// 5. Latency Compensation
+// ==============================================================================
+
+// Delays a signal path by a (possibly fractional) number of samples: the dry
+// path by the wet path's latency, or a faster wet stage up to the latency of
+// the slowest one. Each channel is a ring buffer written and read a block at a
+// time: integer delays are plain memcpys, only a fractional delay interpolates
+// (linearly, like DelayLine<Linear>). A latency change crossfades from the old
+// read position to the new one.
+template <typename T>
+class BasicLatencyCompensator {
+public:
+    void prepare(int numChannels, int maxDelaySamples, int maxBlockSize) {
+        int size = 1;
+        while (size < maxDelaySamples + maxBlockSize + 2) size <<= 1;
+        mask = size - 1;
+        maxDelay = maxDelaySamples;
+        maxBlock = std::max(1, maxBlockSize);
+        rings.assign((size_t)numChannels, std::vector<T>((size_t)size, T(0)));
+        reset();
+    }
+
+    void reset() {
+        for (auto& ring : rings) std::fill(ring.begin(), ring.end(), T(0));
+        writePos = 0;
+        fromLatency = latency;
+        fadeRemaining = 0;
+    }
+
+    // fadeSamples = 0 jumps straight to the new delay
+    void setLatency(float newLatency, int fadeSamples = 0) {
+        newLatency = juce::jlimit(0.0f, (float)maxDelay, newLatency);
+        fromLatency = (fadeRemaining > 0) ? fromLatency : latency;
+        latency = newLatency;
+        fadeLength = fadeRemaining = (fadeSamples > 0 && fromLatency != latency) ? fadeSamples : 0;
+    }
+
+    float getLatency() const { return latency; }
+    int getLatencySamples() const { return juce::roundToInt(latency); }
+
+    // In place: each channel's block is replaced by its delayed signal
+    void process(T* const* channels, int numChannels, int numSamples) {
+        numChannels = std::min(numChannels, (int)rings.size());
+        for (int offset = 0; offset < numSamples; offset += maxBlock)
+            processChunk(channels, numChannels, offset, std::min(maxBlock, numSamples - offset));
+    }
+
+private:
+    void processChunk(T* const* channels, int numChannels, int offset, int n) {
+        for (int ch = 0; ch < numChannels; ++ch) write(rings[(size_t)ch], channels[ch] + offset, n);
+
+        if (fadeRemaining > 0) {
+            const int fadeStart = fadeLength - fadeRemaining;
+            const T invLength = T(1) / (T)fadeLength;
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const auto& ring = rings[(size_t)ch];
+                T* out = channels[ch] + offset;
+                read(ring, out, n, fromLatency);
+                for (int i = 0; i < n; ++i) {
+                    const T a = std::min(T(1), (T)(fadeStart + i + 1) * invLength);
+                    const T target = readSample(ring, writePos + i, latency);
+                    out[i] += a * (target - out[i]);
+                }
+            }
+            fadeRemaining = std::max(0, fadeRemaining - n);
+        }
+        else {
+            for (int ch = 0; ch < numChannels; ++ch) read(rings[(size_t)ch], channels[ch] + offset, n, latency);
+        }
+
+        writePos = (writePos + n) & mask;
+    }
+
+    // Copies a block to the ring at writePos (at most two memcpys around the wrap)
+    void write(std::vector<T>& ring, const T* src, int n) const {
+        const int first = std::min(n, mask + 1 - writePos);
+        std::memcpy(ring.data() + writePos, src, sizeof(T) * (size_t)first);
+        std::memcpy(ring.data(), src + first, sizeof(T) * (size_t)(n - first));
+    }
+
+    // Output sample i of the block is the input from `delay` samples earlier
+    void read(const std::vector<T>& ring, T* dst, int n, float delay) const {
+        const int whole = (int)delay;
+        const T frac = (T)(delay - (float)whole);
+        const int start = (writePos - whole) & mask;
+
+        if (frac == T(0)) {
+            const int first = std::min(n, mask + 1 - start);
+            std::memcpy(dst, ring.data() + start, sizeof(T) * (size_t)first);
+            std::memcpy(dst + first, ring.data(), sizeof(T) * (size_t)(n - first));
+            return;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            const T a = ring[(size_t)((start + i) & mask)];
+            const T b = ring[(size_t)((start + i - 1) & mask)];
+            dst[i] = a + frac * (b - a);
+        }
+    }
+
+    T readSample(const std::vector<T>& ring, int pos, float delay) const {
+        const int whole = (int)delay;
+        const T frac = (T)(delay - (float)whole);
+        const T a = ring[(size_t)((pos - whole) & mask)];
+        if (frac == T(0)) return a;
+        const T b = ring[(size_t)((pos - whole - 1) & mask)];
+        return a + frac * (b - a);
+    }
+
+    std::vector<std::vector<T>> rings;
+    int mask = 0;
+    int writePos = 0;
+    int maxDelay = 0;
+    int maxBlock = 1;
+    float latency = 0.0f, fromLatency = 0.0f;
+    int fadeLength = 0, fadeRemaining = 0;
+};
+
+// The processor reports the dry compensator's getLatencySamples() to the host
+// and nothing else.
+using LatencyCompensator = BasicLatencyCompensator<float>;
+
+// ==============================================================================
+// 6. Adaptive Oversampling
+// ==============================================================================
+
+// Picks the oversampling stage for the "Auto" quality with a level and
+// bandwidth heuristic, not a measurement of aliasing: how far the shaper is
+// driven past a nominal knee (input peak + input gain + drive), a hand-tuned
+// harmonic spread per algorithm, and where the input's energy sits
+// (first-difference RMS over signal RMS). The harmonic reach grows with the
+// overdrive ratio. Harmonic h of a tone at f folds back below fs/2 once
+// h * f > (F - 0.5) * fs, so the stage is the smallest factor F that covers
+// the estimated reach. ADAA order and math tier do not enter the estimate.
+// Moves up apply at once, moves down only after holdSeconds.
+class AdaptiveQualitySelector {
+public:
+    static constexpr int numStages = 5;         // Off, 2x, 4x, 8x, 16x
+    static constexpr double holdSeconds = 0.5;
+    static constexpr float kneeDB = -12.0f;     // nominal shaper level where bending starts
+    static constexpr float silenceLevel = 1.0e-5f;
+
+    // Significant harmonics per unit of overdrive ratio past the knee,
+    // hand-tuned per algorithm
+    static constexpr float harmonicSpread[SatAlgo::NumAlgorithms] = {
+        1.0f, 1.0f, 1.5f, 1.0f, 0.75f,          // Tape, Triode, Pentode, Transformer, Console
+        1.25f, 1.5f, 2.0f,                      // JFET, BJT, Diode
+        1.5f, 4.0f, 6.0f, 3.0f, 8.0f, 2.0f      // Tanh, HardClip, Wavefold, Rectify, Bitcrush, Exciter
+    };
+
+    struct BlockAnalysis {
+        float peak = 0.0f;
+        float hfRatio = 0.0f;   // rms(x[n] - x[n-1]) / rms(x): 2 sin(pi f / fs) for a tone
+    };
+
+    void prepare(double sampleRate) {
+        currentSampleRate = sampleRate;
+        holdSamples = (int)(sampleRate * holdSeconds);
+        reset();
+    }
+
+    void reset() {
+        currentStage = 0;
+        lowerStage = -1;
+        holdCounter = 0;
+    }
+
+    static BlockAnalysis analyse(const float* const* channels, int numChannels, int numSamples) {
+        BlockAnalysis a;
+        double energy = 0.0, diffEnergy = 0.0;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* x = channels[ch];
+            for (int i = 0; i < numSamples; ++i) {
+                a.peak = std::max(a.peak, std::abs(x[i]));
+                energy += (double)x[i] * x[i];
+                if (i > 0) diffEnergy += (double)(x[i] - x[i - 1]) * (x[i] - x[i - 1]);
+            }
+        }
+        a.hfRatio = energy > 0.0 ? (float)std::sqrt(diffEnergy / energy) : 0.0f;
+        return a;
+    }
+
+    // Stage this block would need on its own
+    int estimateStage(int algorithm, const BlockAnalysis& a, float inputGain, float driveDB, float character) const {
+        const float level = a.peak * inputGain;
+        if (level < silenceLevel) return 0;
+
+        const float overDB = 20.0f * std::log10(level) + driveDB - kneeDB;
+        if (overDB <= 0.0f) return 0;
+
+        const float spread = harmonicSpread[juce::jlimit(0, (int)SatAlgo::NumAlgorithms - 1, algorithm)] * (0.75f + 0.5f * character);
+        const double harmonics = 1.0 + spread * (std::pow(10.0, overDB / 20.0) - 1.0);
+        const double toneFreq = std::max(20.0, currentSampleRate / juce::MathConstants<double>::pi * std::asin(std::min(1.0f, 0.5f * a.hfRatio)));
+        const double factor = harmonics * toneFreq / currentSampleRate + 0.5;
+
+        int stage = 0;
+        while (stage < numStages - 1 && (double)(1 << stage) < factor) ++stage;
+        return stage;
+    }
+
+    // Stage to run for this block, with hysteresis against flapping
+    int update(int algorithm, const BlockAnalysis& a, float inputGain, float driveDB, float character, int numSamples) {
+        return update(estimateStage(algorithm, a, inputGain, driveDB, character), numSamples);
+    }
+
+    // Same, for a stage the caller estimated (e.g. the most demanding band)
+    int update(int wanted, int numSamples) {
+        if (wanted >= currentStage) {
+            currentStage = wanted;
+            lowerStage = -1;
+            holdCounter = 0;
+        }
+        else {
+            // Drop to the highest stage asked for during the hold time
+            lowerStage = std::max(lowerStage, wanted);
+            holdCounter += numSamples;
+            if (holdCounter >= holdSamples) {
+                currentStage = lowerStage;
+                lowerStage = -1;
+                holdCounter = 0;
+            }
+        }
+        return currentStage;
+    }
+
+private:
+    double currentSampleRate = 44100.0;
+    int holdSamples = 22050;
+    int currentStage = 0;
+    int lowerStage = -1;
+    int holdCounter = 0;
+};
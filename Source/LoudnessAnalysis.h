@@ -0,0 +1,331 @@
+// --- START OF FILE LoudnessAnalysis.h ---
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+// ==============================================================================
+// 1. Loudness Meter (ITU-R BS.1770-4)
+// ==============================================================================
+//
+// K-weighting (high shelf + RLB high-pass, coefficients derived for any rate),
+// 400 ms gating blocks on a 100 ms hop, absolute gate at -70 LUFS and
+// relative gate at -10 LU. Every channel is weighted 1.0 (the plugin has no
+// notion of surround positions). True peak is the maximum of the sample
+// peak and a 4x windowed-sinc interpolation (2x from 88.2 kHz, none from
+// 176.4 kHz), as in Annex 2, with every phase normalised to unity gain at DC.
+// Not realtime safe: the block history grows as it measures.
+
+class LoudnessMeter {
+public:
+    void prepare(double sampleRate, int numChannels) {
+        currentSampleRate = sampleRate;
+        channels.assign((size_t)numChannels, {});
+        hopSamples = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+        oversampling = sampleRate >= 176400.0 ? 1 : (sampleRate >= 88200.0 ? 2 : 4);
+        designKWeighting();
+        designInterpolator();
+        reset();
+    }
+
+    void reset() {
+        for (auto& c : channels) c.reset();
+        hopPowers = {};
+        hopCount = 0;
+        hopPosition = 0;
+        hopEnergy = 0.0;
+        blockLoudness.clear();
+        measuredSamples = 0;
+        truePeak = 0.0f;
+    }
+
+    void process(const float* const* data, int numChannels, int numSamples) {
+        numChannels = juce::jmin(numChannels, (int)channels.size());
+        for (int i = 0; i < numSamples; ++i) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto& c = channels[(size_t)ch];
+                const double x = data[ch][i];
+                hopEnergy += c.kWeight(x, shelf, highPass);
+                truePeak = std::max(truePeak, c.peak((float)x, interpolator, oversampling));
+            }
+
+            if (++hopPosition >= hopSamples) finishHop();
+        }
+        measuredSamples += numSamples;
+    }
+
+    // Gated integrated loudness in LUFS (-inf until a block passes the gates)
+    double getIntegratedLoudness() const {
+        double sum = 0.0;
+        int count = 0;
+        for (double l : blockLoudness) {
+            if (l > absoluteGate) { sum += std::pow(10.0, (l + 0.691) / 10.0); ++count; }
+        }
+        if (count == 0) return -std::numeric_limits<double>::infinity();
+
+        const double relativeGate = toLoudness(sum / count) - 10.0;
+        sum = 0.0;
+        count = 0;
+        for (double l : blockLoudness) {
+            if (l > absoluteGate && l > relativeGate) { sum += std::pow(10.0, (l + 0.691) / 10.0); ++count; }
+        }
+        return count > 0 ? toLoudness(sum / count) : -std::numeric_limits<double>::infinity();
+    }
+
+    float getTruePeakDB() const { return juce::Decibels::gainToDecibels(truePeak, -200.0f); }
+    double getMeasuredSeconds() const { return (double)measuredSamples / currentSampleRate; }
+
+    static constexpr double absoluteGate = -70.0;
+
+private:
+    struct Biquad { double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0; };
+
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int maxPhases = 4;
+
+    struct Channel {
+        double s1[2] {}, s2[2] {};
+        std::array<float, tapsPerPhase> history {};
+        int historyPos = 0;
+
+        void reset() { *this = {}; }
+
+        // Transposed direct form II, shelf then high-pass; returns z^2
+        double kWeight(double x, const Biquad& a, const Biquad& b) {
+            double y = a.b0 * x + s1[0];
+            s1[0] = a.b1 * x - a.a1 * y + s2[0];
+            s2[0] = a.b2 * x - a.a2 * y;
+            const double z = b.b0 * y + s1[1];
+            s1[1] = b.b1 * y - b.a1 * z + s2[1];
+            s2[1] = b.b2 * y - b.a2 * z;
+            return z * z;
+        }
+
+        float peak(float x, const std::array<std::array<float, tapsPerPhase>, maxPhases>& phases, int numPhases) {
+            history[(size_t)historyPos] = x;
+            historyPos = (historyPos + 1) % tapsPerPhase;
+            float p = std::abs(x);
+            if (numPhases == 1) return p;
+
+            for (int ph = 0; ph < numPhases; ++ph) {
+                float acc = 0.0f;
+                for (int t = 0; t < tapsPerPhase; ++t)
+                    acc += phases[(size_t)ph][(size_t)t] * history[(size_t)((historyPos + tapsPerPhase - 1 - t) % tapsPerPhase)];
+                p = std::max(p, std::abs(acc));
+            }
+            return p;
+        }
+    };
+
+    static double toLoudness(double meanPower) { return -0.691 + 10.0 * std::log10(std::max(meanPower, 1.0e-30)); }
+
+    void finishHop() {
+        hopPowers[(size_t)(hopCount % 4)] = hopEnergy / hopSamples;
+        hopEnergy = 0.0;
+        hopPosition = 0;
+        if (++hopCount >= 4) {
+            const double power = 0.25 * (hopPowers[0] + hopPowers[1] + hopPowers[2] + hopPowers[3]);
+            blockLoudness.push_back(toLoudness(power));
+        }
+    }
+
+    // BS.1770 pre-filter and RLB weighting, re-derived for the current rate
+    void designKWeighting() {
+        const double pi = juce::MathConstants<double>::pi;
+        {
+            const double f0 = 1681.974450955533, G = 3.999843853973347, Q = 0.7071752369554196;
+            const double K = std::tan(pi * f0 / currentSampleRate);
+            const double Vh = std::pow(10.0, G / 20.0), Vb = std::pow(Vh, 0.4996667741545416);
+            const double a0 = 1.0 + K / Q + K * K;
+            shelf = { (Vh + Vb * K / Q + K * K) / a0, 2.0 * (K * K - Vh) / a0, (Vh - Vb * K / Q + K * K) / a0,
+                      2.0 * (K * K - 1.0) / a0, (1.0 - K / Q + K * K) / a0 };
+        }
+        {
+            const double f0 = 38.13547087602444, Q = 0.5003270373238773;
+            const double K = std::tan(pi * f0 / currentSampleRate);
+            const double a0 = 1.0 + K / Q + K * K;
+            highPass = { 1.0, -2.0, 1.0, 2.0 * (K * K - 1.0) / a0, (1.0 - K / Q + K * K) / a0 };
+        }
+    }
+
+    // Polyphase windowed sinc (Hann), cutoff at the original Nyquist
+    void designInterpolator() {
+        const int length = tapsPerPhase * oversampling;
+        const double centre = 0.5 * (length - 1);
+        for (int ph = 0; ph < oversampling; ++ph) {
+            std::array<double, tapsPerPhase> taps;
+            double sum = 0.0;
+            for (int t = 0; t < tapsPerPhase; ++t) {
+                const double n = t * oversampling + ph - centre;
+                const double x = n / oversampling;
+                const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                const double window = 0.5 + 0.5 * std::cos(juce::MathConstants<double>::twoPi * n / (length + 1));
+                taps[(size_t)t] = sinc * window;
+                sum += taps[(size_t)t];
+            }
+            // Unity DC gain per phase, so a held level reads as itself
+            for (int t = 0; t < tapsPerPhase; ++t) interpolator[(size_t)ph][(size_t)t] = (float)(taps[(size_t)t] / sum);
+        }
+    }
+
+    double currentSampleRate = 48000.0;
+    std::vector<Channel> channels;
+    Biquad shelf, highPass;
+    std::array<std::array<float, tapsPerPhase>, maxPhases> interpolator {};
+    int oversampling = 4;
+
+    int hopSamples = 4800;
+    int hopPosition = 0;
+    double hopEnergy = 0.0;
+    std::array<double, 4> hopPowers {};
+    int64_t hopCount = 0;
+    std::vector<double> blockLoudness;
+    int64_t measuredSamples = 0;
+    float truePeak = 0.0f;
+};
+
+// ==============================================================================
+// 2. AutoGain Analyser (worker thread)
+// ==============================================================================
+//
+// The audio thread only copies input/output blocks into a lock-free FIFO;
+// a worker drains it into two LoudnessMeters and, once a session has
+// measured sessionSeconds, publishes the result for the message thread.
+// Sessions are numbered: starting or cancelling one bumps the number, the
+// worker restarts its meters when it sees a new one, and a result only
+// counts while its session is still the current one.
+
+class AutoGainAnalyser : private juce::Thread {
+public:
+    struct Result {
+        double inputLoudness = 0.0;     // LUFS
+        double outputLoudness = 0.0;    // LUFS
+        float inputTruePeakDB = 0.0f;   // dBTP
+    };
+
+    AutoGainAnalyser() : juce::Thread("AutoGain Loudness") {}
+    ~AutoGainAnalyser() override { stopThread(2000); }
+
+    // Message thread; stops the worker while the buffers are rebuilt
+    void prepare(double sampleRate, int channels, double secondsToMeasure) {
+        stopThread(2000);
+        numChannels = juce::jmax(1, channels);
+        sessionSeconds = secondsToMeasure;
+        const int capacity = juce::jmax(4096, juce::roundToInt(sampleRate));   // one second of headroom
+        fifo.setTotalSize(capacity);
+        fifo.reset();
+        storage.setSize(2 * numChannels, capacity);
+        inputMeter.prepare(sampleRate, numChannels);
+        outputMeter.prepare(sampleRate, numChannels);
+        workerSession = -1;
+        startThread();
+    }
+
+    void release() { stopThread(2000); }
+
+    // --- Audio thread ---
+    void startSession() { sessionId.fetch_add(1, std::memory_order_release); }
+    void cancelSession() { sessionId.fetch_add(1, std::memory_order_release); }
+
+    // Drops the block if the worker has fallen a second behind
+    void push(const float* const* input, const float* const* output, int channels, int numSamples) {
+        if (fifo.getFreeSpace() < numSamples) return;
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* in = ch < channels ? input[ch] : nullptr;
+            const float* out = ch < channels ? output[ch] : nullptr;
+            copyOrClear(storage.getWritePointer(ch), in, start1, size1, start2, size2);
+            copyOrClear(storage.getWritePointer(numChannels + ch), out, start1, size1, start2, size2);
+        }
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    bool hasResult() const {
+        return resultSession.load(std::memory_order_acquire) == sessionId.load(std::memory_order_acquire);
+    }
+
+    // --- Message thread ---
+    // Takes the current session's result (once)
+    bool fetchResult(Result& r) {
+        if (!hasResult()) return false;
+        r.inputLoudness = inputLoudness.load();
+        r.outputLoudness = outputLoudness.load();
+        r.inputTruePeakDB = inputTruePeak.load();
+        resultSession.store(-1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    void run() override {
+        while (!threadShouldExit()) {
+            drain();
+            wait(20);
+        }
+    }
+
+    void drain() {
+        const int session = sessionId.load(std::memory_order_acquire);
+        if (session != workerSession) {
+            workerSession = session;
+            inputMeter.reset();
+            outputMeter.reset();
+            published = false;
+        }
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+        measure(start1, size1);
+        measure(start2, size2);
+        fifo.finishedRead(size1 + size2);
+
+        if (!published && inputMeter.getMeasuredSeconds() >= sessionSeconds) {
+            inputLoudness.store(inputMeter.getIntegratedLoudness());
+            outputLoudness.store(outputMeter.getIntegratedLoudness());
+            inputTruePeak.store(inputMeter.getTruePeakDB());
+            resultSession.store(workerSession, std::memory_order_release);
+            published = true;
+        }
+    }
+
+    void measure(int start, int numSamples) {
+        if (numSamples <= 0) return;
+        const float* in[16] {};
+        const float* out[16] {};
+        const int channels = juce::jmin(numChannels, 16);
+        for (int ch = 0; ch < channels; ++ch) {
+            in[ch] = storage.getReadPointer(ch, start);
+            out[ch] = storage.getReadPointer(numChannels + ch, start);
+        }
+        inputMeter.process(in, channels, numSamples);
+        outputMeter.process(out, channels, numSamples);
+    }
+
+    static void copyOrClear(float* dst, const float* src, int start1, int size1, int start2, int size2) {
+        if (src == nullptr) {
+            std::fill(dst + start1, dst + start1 + size1, 0.0f);
+            std::fill(dst + start2, dst + start2 + size2, 0.0f);
+            return;
+        }
+        std::copy(src, src + size1, dst + start1);
+        std::copy(src + size1, src + size1 + size2, dst + start2);
+    }
+
+    juce::AbstractFifo fifo { 4096 };
+    juce::AudioBuffer<float> storage;   // [0, n) input, [n, 2n) output
+    int numChannels = 2;
+    double sessionSeconds = 3.0;
+
+    std::atomic<int> sessionId { 0 };
+    std::atomic<int> resultSession { -1 };
+    std::atomic<double> inputLoudness { 0.0 }, outputLoudness { 0.0 };
+    std::atomic<float> inputTruePeak { 0.0f };
+
+    // Worker only
+    LoudnessMeter inputMeter, outputMeter;
+    int workerSession = -1;
+    bool published = false;
+};
@@ -0,0 +1,131 @@
+// --- START OF FILE ParameterSnapshot.h ---
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// ==============================================================================
+// Parameter Snapshot
+// ==============================================================================
+//
+// Every parameter the audio thread reads is listed once below, as
+// X(name, type) with the member name doubling as the parameter ID and the
+// type being what the DSP reads (float, int for choices, bool for toggles).
+// The list generates the ParamId enum, one cached std::atomic<float>* per
+// parameter and a typed accessor per parameter. capture() copies every value once per block and
+// returns a bitmask of the parameters that changed since the previous
+// capture, so each stage only recomputes what depends on those bits.
+
+#define NGS_PARAMETERS(X) \
+    X(inputGain, float) X(autoGain, bool) X(bypass, bool) \
+    X(preLowCut, float) X(preHighCut, float) \
+    X(satType, int) X(drive, float) X(character, float) \
+    X(quality, int) X(osFilter, int) \
+    X(postLowCut, float) X(postHighCut, float) X(postSlope, int) \
+    X(mix, float) X(outputGain, float) X(safetyClip, bool) \
+    X(mathTier, int) X(adaaOrder, int) \
+    X(bands, int) X(crossover1, float) X(crossover2, float) X(crossover3, float) \
+    X(band1Type, int) X(band1Drive, float) X(band1Character, float) \
+    X(band2Type, int) X(band2Drive, float) X(band2Character, float) \
+    X(band3Type, int) X(band3Drive, float) X(band3Character, float) \
+    X(band4Type, int) X(band4Drive, float) X(band4Character, float)
+
+namespace ParamId {
+    enum Id : int {
+       #define NGS_PARAMETER_ENUM(name, type) name,
+        NGS_PARAMETERS(NGS_PARAMETER_ENUM)
+       #undef NGS_PARAMETER_ENUM
+        NumParameters
+    };
+
+    // Per-band parameters repeat with this stride: bandParam(band1Drive, 2) is band3Drive
+    constexpr int bandStride = band2Type - band1Type;
+    constexpr int bandParam(Id band1Id, int band) { return band1Id + band * bandStride; }
+    constexpr int crossover(int k) { return crossover1 + k; }
+}
+
+using ParamMask = std::uint64_t;
+static_assert(ParamId::NumParameters <= 64, "ParamMask has one bit per parameter");
+
+constexpr ParamMask paramBit(int id) { return ParamMask(1) << id; }
+
+// Bits [first, first + count)
+constexpr ParamMask paramBits(int first, int count) {
+    return (count >= 64 ? ~ParamMask(0) : ((ParamMask(1) << count) - 1)) << first;
+}
+
+constexpr ParamMask allParamBits = paramBits(0, ParamId::NumParameters);
+
+class ParameterSnapshot {
+public:
+    // Looks up every handle by ID. Message thread only: the lookups allocate.
+    void attach(juce::AudioProcessorValueTreeState& apvts) {
+        static constexpr const char* ids[] = {
+           #define NGS_PARAMETER_ID(name, type) #name,
+            NGS_PARAMETERS(NGS_PARAMETER_ID)
+           #undef NGS_PARAMETER_ID
+        };
+        for (int i = 0; i < ParamId::NumParameters; ++i) {
+            handles[(size_t)i] = apvts.getRawParameterValue(ids[i]);
+            jassert(handles[(size_t)i] != nullptr);
+        }
+        markAllChanged();
+    }
+
+    // Audio thread: one relaxed load per parameter, no lookups. Returns the
+    // parameters that changed since the previous capture.
+    ParamMask capture() {
+        ParamMask mask = pendingMask;
+        for (int i = 0; i < ParamId::NumParameters; ++i) {
+            const float v = handles[(size_t)i]->load(std::memory_order_relaxed);
+            if (v != values[(size_t)i]) mask |= paramBit(i);
+            values[(size_t)i] = v;
+        }
+        pendingMask = 0;
+        changedMask = mask;
+        return mask;
+    }
+
+    // The next capture reports every parameter (after prepareToPlay or a reset)
+    void markAllChanged() { pendingMask = allParamBits; }
+
+    ParamMask getChanged() const { return changedMask; }
+    bool changed(ParamMask bits) const { return (changedMask & bits) != 0; }
+
+    // Snapshot values
+   #define NGS_PARAMETER_GETTER(name, type) type name() const { return as<type>(values[ParamId::name]); }
+    NGS_PARAMETERS(NGS_PARAMETER_GETTER)
+   #undef NGS_PARAMETER_GETTER
+
+    // Indexed groups, typed like band1Type() etc.
+    float crossover(int k) const { return as<float>(values[(size_t)ParamId::crossover(k)]); }
+    int bandType(int band) const { return as<int>(values[(size_t)ParamId::bandParam(ParamId::band1Type, band)]); }
+    float bandDrive(int band) const { return as<float>(values[(size_t)ParamId::bandParam(ParamId::band1Drive, band)]); }
+    float bandCharacter(int band) const { return as<float>(values[(size_t)ParamId::bandParam(ParamId::band1Character, band)]); }
+
+    // Live value, for code outside processBlock
+    float load(int id) const { return handles[(size_t)id]->load(); }
+
+private:
+    // Choices store their index and toggles 0/1 as floats
+    template <typename T>
+    static T as(float v) {
+        if constexpr (std::is_same_v<T, bool>) return v > 0.5f;
+        else return (T)v;
+    }
+
+    std::array<std::atomic<float>*, ParamId::NumParameters> handles {};
+    std::array<float, ParamId::NumParameters> values = makeUnset();
+    ParamMask changedMask = 0;
+    ParamMask pendingMask = allParamBits;
+
+    static std::array<float, ParamId::NumParameters> makeUnset() {
+        std::array<float, ParamId::NumParameters> v;
+        v.fill(std::numeric_limits<float>::quiet_NaN());
+        return v;
+    }
+};
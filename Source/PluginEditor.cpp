@@ -205,7 +205,7 @@ NextGenSaturationAudioProcessorEditor::NextGenSaturationAudioProcessorEditor(Nex
     : AudioProcessorEditor(&p), audioProcessor(p)
 {
     setLookAndFeel(&abletonLnF);
-    setSize(800, 350);
+    setSize(800, 350 + stripHeight + analyserHeight);
 
     addKnob(inputGainSlider, "inputGain", "Input", " dB", juce::String::fromUTF8((const char*)u8"入力レベルを調整します。"));
 
@@ -253,9 +253,16 @@ NextGenSaturationAudioProcessorEditor::NextGenSaturationAudioProcessorEditor(Nex
     addKnob(driveSlider, "drive", "Drive", " dB", juce::String::fromUTF8((const char*)u8"歪みの深さを調整します。"));
     addKnob(charSlider, "character", "Char", "", juce::String::fromUTF8((const char*)u8"アルゴリズムごとの特性（非対称性など）を調整します。"));
     addCombo(qualityCombo, "quality", juce::String::fromUTF8((const char*)u8"オーバーサンプリング倍率を設定します。"));
+    addCombo(osFilterCombo, "osFilter", juce::String::fromUTF8((const char*)u8"オーバーサンプリングのフィルタ方式を設定します。"));
 
-    visualizer.setProcessor(&audioProcessor);
+    addAndMakeVisible(cpuMeter);
     addAndMakeVisible(visualizer);
+    addAndMakeVisible(spectrum);
+    addAndMakeVisible(transferCurve);
+    satTypeValue = audioProcessor.apvts.getRawParameterValue("satType");
+    driveValue = audioProcessor.apvts.getRawParameterValue("drive");
+    characterValue = audioProcessor.apvts.getRawParameterValue("character");
+    audioProcessor.telemetry.subscribe();
 
     addKnob(postLowCutSlider, "postLowCut", "Low Cut", " Hz", juce::String::fromUTF8((const char*)u8"最終的な低域を調整します。"));
     addKnob(postHighCutSlider, "postHighCut", "High Cut", " Hz", juce::String::fromUTF8((const char*)u8"最終的な高域を調整します。"));
@@ -265,6 +272,36 @@ NextGenSaturationAudioProcessorEditor::NextGenSaturationAudioProcessorEditor(Nex
     addKnob(outputGainSlider, "outputGain", "Output", " dB", juce::String::fromUTF8((const char*)u8"最終出力レベルを調整します。"));
     addButton(safetyClipButton, "safetyClip", "Safe", juce::String::fromUTF8((const char*)u8"0dBを超えないようにクリッピングします。"));
 
+    // Multiband strip
+    addCombo(bandsCombo, "bands", juce::String::fromUTF8((const char*)u8"帯域を分割して、帯域ごとに歪ませます。"));
+    bandsCombo.nameJP = "Bands";
+    for (int k = 0; k < maxBands - 1; ++k) {
+        addKnob(crossoverSliders[(size_t)k], "crossover" + juce::String(k + 1), "Split " + juce::String(k + 1), " Hz",
+            juce::String::fromUTF8((const char*)u8"帯域の分割周波数です（LR4クロスオーバー）。"));
+    }
+    for (int b = 0; b < maxBands; ++b) {
+        auto& button = bandSelectButtons[(size_t)b];
+        addAndMakeVisible(button);
+        button.setButtonText(juce::String(b + 1));
+        button.setRadioGroupId(1);
+        button.setClickingTogglesState(true);
+        button.onClick = [this, b]() {
+            if (bandSelectButtons[(size_t)b].getToggleState()) showBand(b);
+            };
+    }
+    addCombo(bandTypeCombo, "band1Type", juce::String::fromUTF8((const char*)u8"この帯域のアルゴリズムです。Mainはメインの設定に従います。"), false);
+    addKnob(bandDriveSlider, "band1Drive", "Drive", " dB", juce::String::fromUTF8((const char*)u8"メインのDriveに加算されます。"), false);
+    addKnob(bandCharSlider, "band1Character", "Char", "", juce::String::fromUTF8((const char*)u8"メインのCharに加算されます。"), false);
+    bandsValue = audioProcessor.apvts.getRawParameterValue("bands");
+    showBand(0);
+    updateBandControls();
+
+    // Processing strip
+    addCombo(mathTierCombo, "mathTier", juce::String::fromUTF8((const char*)u8"ADAAの数学関数の精度です。Autoはリアルタイム再生ではFast、オフラインレンダリングではExactを使います。"));
+    mathTierCombo.nameJP = "Precision";
+    addCombo(adaaOrderCombo, "adaaOrder", juce::String::fromUTF8((const char*)u8"アンチエイリアシングの次数です。ADAA 2は1サンプル遅延と引き換えにエイリアスをさらに抑えます。"));
+    adaaOrderCombo.nameJP = "Anti-Aliasing";
+
     addAndMakeVisible(infoBar);
     infoBar.setColour(juce::Label::backgroundColourId, juce::Colour(0xFFE0E0E0));
     infoBar.setColour(juce::Label::textColourId, juce::Colours::darkgrey);
@@ -290,9 +327,11 @@ NextGenSaturationAudioProcessorEditor::NextGenSaturationAudioProcessorEditor(Nex
 NextGenSaturationAudioProcessorEditor::~NextGenSaturationAudioProcessorEditor() {
     setLookAndFeel(nullptr);
     stopTimer();
+    audioProcessor.telemetry.unsubscribe();
+    audioProcessor.cpuMeter.setStageTimingEnabled(false);
 }
 
-void NextGenSaturationAudioProcessorEditor::addKnob(AbletonKnob& knob, const juce::String& paramID, const juce::String& labelText, const juce::String& suffix, const juce::String& descJP) {
+void NextGenSaturationAudioProcessorEditor::addKnob(AbletonKnob& knob, const juce::String& paramID, const juce::String& labelText, const juce::String& suffix, const juce::String& descJP, bool attach) {
     addAndMakeVisible(knob);
     knob.setup(labelText, suffix);
     knob.nameJP = labelText;
@@ -303,10 +342,10 @@ void NextGenSaturationAudioProcessorEditor::addKnob(AbletonKnob& knob, const juc
         infoBarHoldCounter = 100;
         };
 
-    sliderAtts.push_back(std::make_unique<SliderAtt>(audioProcessor.apvts, paramID, knob));
+    if (attach) sliderAtts.push_back(std::make_unique<SliderAtt>(audioProcessor.apvts, paramID, knob));
 }
 
-void NextGenSaturationAudioProcessorEditor::addCombo(InfoBarCombo& box, const juce::String& paramID, const juce::String& descJP) {
+void NextGenSaturationAudioProcessorEditor::addCombo(InfoBarCombo& box, const juce::String& paramID, const juce::String& descJP, bool attach) {
     addAndMakeVisible(box);
     box.addItemList(audioProcessor.apvts.getParameter(paramID)->getAllValueStrings(), 1);
     box.nameJP = paramID;
@@ -317,7 +356,7 @@ void NextGenSaturationAudioProcessorEditor::addCombo(InfoBarCombo& box, const ju
         infoBarHoldCounter = 100;
         };
 
-    comboAtts.push_back(std::make_unique<ComboAtt>(audioProcessor.apvts, paramID, box));
+    if (attach) comboAtts.push_back(std::make_unique<ComboAtt>(audioProcessor.apvts, paramID, box));
 }
 
 void NextGenSaturationAudioProcessorEditor::addButton(InfoBarButton& btn, const juce::String& paramID, const juce::String& nameJP, const juce::String& descJP) {
@@ -340,7 +379,7 @@ void NextGenSaturationAudioProcessorEditor::paint(juce::Graphics& g)
 
     g.setColour(juce::Colours::grey.withAlpha(0.3f));
     int w = getWidth();
-    int h = getHeight();
+    int h = getHeight() - stripHeight - analyserHeight;   // the control and analyzer strips sit above the info bar
     int secW = w / 5;
 
     // Adjusted vertical lines (first line shortened for logo area)
@@ -359,7 +398,24 @@ void NextGenSaturationAudioProcessorEditor::paint(juce::Graphics& g)
 
     g.setFont(juce::Font("Meiryo UI", 11.0f, juce::Font::bold));
     g.setColour(juce::Colours::grey);
-    g.drawText("QUALITY", secW * 2, h - 45, secW, 20, juce::Justification::centred);
+    g.drawText("QUALITY", secW * 2, h - 45, secW / 2, 20, juce::Justification::centred);   // CPU meter alongside
+
+    // Control strip
+    g.setColour(juce::Colours::grey.withAlpha(0.3f));
+    g.drawLine(15.0f, static_cast<float>(multibandArea.getY()), static_cast<float>(w - 15), static_cast<float>(multibandArea.getY()), 1.0f);
+    g.drawLine(static_cast<float>(processingArea.getX() - 5), static_cast<float>(processingArea.getY() + 5),
+        static_cast<float>(processingArea.getX() - 5), static_cast<float>(processingArea.getBottom()), 1.0f);
+
+    g.setColour(juce::Colours::darkgrey);
+    g.setFont(juce::Font("Meiryo UI", 13.0f, juce::Font::bold));
+    g.drawText("MULTIBAND", multibandArea.withHeight(20), juce::Justification::centred);
+    g.drawText("PROCESSING", processingArea.withHeight(20), juce::Justification::centred);
+
+    g.setFont(juce::Font("Meiryo UI", 11.0f, juce::Font::bold));
+    g.setColour(juce::Colours::grey);
+    g.drawText("Precision", mathTierCombo.getBounds().withX(processingArea.getX()).withRight(mathTierCombo.getX() - 4), juce::Justification::centredLeft);
+    g.drawText("ADAA", adaaOrderCombo.getBounds().withX(processingArea.getX()).withRight(adaaOrderCombo.getX() - 4), juce::Justification::centredLeft);
+    g.drawText("Band", bandTypeCombo.getBounds().translated(0, bandTypeCombo.getHeight()), juce::Justification::centred);
 }
 
 void NextGenSaturationAudioProcessorEditor::resized()
@@ -367,6 +423,38 @@ void NextGenSaturationAudioProcessorEditor::resized()
     auto area = getLocalBounds();
     auto footer = area.removeFromBottom(30);
     infoBar.setBounds(footer);
+    auto rAnalyser = area.removeFromBottom(analyserHeight).reduced(15, 5);
+    transferCurve.setBounds(rAnalyser.removeFromLeft(rAnalyser.getHeight()));
+    rAnalyser.removeFromLeft(10);
+    spectrum.setBounds(rAnalyser);
+
+    // Control strip: multiband on the left, processing options on the right
+    auto rStrip = area.removeFromBottom(stripHeight).reduced(15, 0);
+    rStrip.removeFromBottom(5);
+    processingArea = rStrip.removeFromRight(150);
+    rStrip.removeFromRight(10);
+    multibandArea = rStrip;
+
+    auto rProc = processingArea.withTrimmedTop(25);
+    mathTierCombo.setBounds(rProc.removeFromTop(25).withTrimmedLeft(60));
+    rProc.removeFromTop(8);
+    adaaOrderCombo.setBounds(rProc.removeFromTop(25).withTrimmedLeft(60));
+
+    auto rBands = multibandArea.withTrimmedTop(22);
+    auto rBandMode = rBands.removeFromLeft(130).withTrimmedTop(3);
+    bandsCombo.setBounds(rBandMode.removeFromTop(25));
+    rBandMode.removeFromTop(8);
+    auto rSelect = rBandMode.removeFromTop(25);
+    const int selectW = rSelect.getWidth() / maxBands;
+    for (auto& button : bandSelectButtons) button.setBounds(rSelect.removeFromLeft(selectW).reduced(2, 0));
+
+    const int stripKnobW = 68;
+    rBands.removeFromLeft(10);
+    for (auto& knob : crossoverSliders) knob.setBounds(rBands.removeFromLeft(stripKnobW));
+    rBands.removeFromLeft(10);
+    bandTypeCombo.setBounds(rBands.removeFromLeft(110).withTrimmedTop(3).withHeight(25));
+    bandDriveSlider.setBounds(rBands.removeFromLeft(stripKnobW));
+    bandCharSlider.setBounds(rBands.removeFromLeft(stripKnobW));
 
     auto mainArea = area.reduced(10);
     mainArea.removeFromTop(20);
@@ -386,7 +474,7 @@ void NextGenSaturationAudioProcessorEditor::resized()
     int logoAreaX = 10;
     int logoAreaY = bypassButton.getBottom() + 8;
     int logoAreaW = secW * 2;
-    int logoAreaH = footer.getY() - logoAreaY - 5;
+    int logoAreaH = area.getBottom() - logoAreaY - 5;
 
     auto logoImage = juce::ImageCache::getFromMemory(BinaryData::logo_png, BinaryData::logo_pngSize);
     if (logoImage.isValid() && logoAreaH > 0 && logoAreaW > 0) {
@@ -417,7 +505,10 @@ void NextGenSaturationAudioProcessorEditor::resized()
     auto rSatKnobs = rSat.removeFromTop(110);
     driveSlider.setBounds(rSatKnobs.removeFromLeft(rSatKnobs.getWidth() / 2));
     charSlider.setBounds(rSatKnobs);
-    qualityCombo.setBounds(rSat.removeFromBottom(25));
+    auto rQuality = rSat.removeFromBottom(25);
+    cpuMeter.setBounds(rQuality.getCentreX(), rQuality.getBottom(), rQuality.getRight() - rQuality.getCentreX(), 20);
+    qualityCombo.setBounds(rQuality.removeFromLeft(rQuality.getWidth() / 2).withTrimmedRight(2));
+    osFilterCombo.setBounds(rQuality.withTrimmedLeft(2));
 
     auto rPost = mainArea.removeFromLeft(secW).reduced(5);
     postLowCutSlider.setBounds(rPost.removeFromTop(110));
@@ -431,7 +522,21 @@ void NextGenSaturationAudioProcessorEditor::resized()
 }
 
 void NextGenSaturationAudioProcessorEditor::timerCallback() {
+    // One read of the processor's telemetry feeds both displays
+    audioProcessor.telemetry.read([this](const float* const* streams, int numSamples) {
+        visualizer.push(streams, numSamples);
+        spectrum.push(streams[NextGenSaturationAudioProcessor::telemetryOutput], numSamples);
+    });
     visualizer.update();
+    spectrum.setSampleRate(audioProcessor.getSampleRate());
+    spectrum.update();
+    transferCurve.setParameters((int)satTypeValue->load(), driveValue->load(), characterValue->load());
+    updateBandControls();
+
+    if (++cpuStatsCounter >= cpuStatsTicks) {
+        cpuStatsCounter = 0;
+        cpuMeter.setStats(audioProcessor.cpuMeter.takeStats());
+    }
 
     auto* hovered = dynamic_cast<juce::Component*>(juce::Desktop::getInstance().getMainMouseSource().getComponentUnderMouse());
     bool isHovering = false;
@@ -447,6 +552,19 @@ void NextGenSaturationAudioProcessorEditor::timerCallback() {
             updateInfoBar(juce::String::fromUTF8((const char*)u8"Algorithm : ") + satTypeCombo.getText() + juce::String::fromUTF8((const char*)u8"  ---  ") + desc);
             isHovering = true;
         }
+        else if (hovered == &qualityCombo || hovered == &osFilterCombo) {
+            updateInfoBar(getLatencyInfo());
+            isHovering = true;
+        }
+        else if (hovered == &cpuMeter) {
+            updateInfoBar(getCpuInfo());
+            isHovering = true;
+        }
+        else if (hovered == &bandsCombo || hovered == &bandTypeCombo || hovered == &mathTierCombo || hovered == &adaaOrderCombo) {
+            auto* box = static_cast<InfoBarCombo*>(hovered);
+            updateInfoBar(box->nameJP + juce::String::fromUTF8((const char*)u8" : ") + box->getText() + juce::String::fromUTF8((const char*)u8"  ---  ") + box->description);
+            isHovering = true;
+        }
         else if (dynamic_cast<juce::ComboBox*>(hovered)) {
             updateInfoBar(juce::String::fromUTF8((const char*)u8"Select Option"));
             isHovering = true;
@@ -463,6 +581,9 @@ void NextGenSaturationAudioProcessorEditor::timerCallback() {
             else if (hovered == &bypassButton) {
                 updateInfoBar(juce::String::fromUTF8((const char*)u8"Bypass : Compare with original signal"));
             }
+            else if (std::any_of(bandSelectButtons.begin(), bandSelectButtons.end(), [hovered](const InfoBarButton& b) { return hovered == &b; })) {
+                updateInfoBar(juce::String::fromUTF8((const char*)u8"Band : Select the band to edit"));
+            }
             else {
                 updateInfoBar(juce::String::fromUTF8((const char*)u8"Switch On/Off"));
             }
@@ -470,6 +591,9 @@ void NextGenSaturationAudioProcessorEditor::timerCallback() {
         }
     }
 
+    // The per-stage breakdown costs a few tick reads per block: only while it is shown
+    audioProcessor.cpuMeter.setStageTimingEnabled(hovered == &cpuMeter);
+
     if (isHovering) {
         infoBarHoldCounter = 100;
     }
@@ -494,6 +618,81 @@ void NextGenSaturationAudioProcessorEditor::timerCallback() {
     }
 }
 
+// Current latency, and what each filter family would cost at this quality
+juce::String NextGenSaturationAudioProcessorEditor::getLatencyInfo() const {
+    const double sampleRate = audioProcessor.getSampleRate();
+    const int latency = audioProcessor.getLatencySamples();
+    juce::String text = "Latency : " + juce::String(latency) + " smp";
+    if (sampleRate > 0.0) text << " (" << juce::String(1000.0 * latency / sampleRate, 2) << " ms)";
+
+    const int quality = qualityCombo.getSelectedItemIndex();
+    text << "  ---  ";
+    for (int f = 0; f < osFilterCombo.getNumItems(); ++f) {
+        if (f > 0) text << " / ";
+        text << osFilterCombo.getItemText(f) << " " << juce::String(audioProcessor.getStageLatency(quality, f), 1);
+    }
+    return text;
+}
+
+// Load statistics over the last window, in % of the buffer duration
+juce::String NextGenSaturationAudioProcessorEditor::getCpuInfo() const {
+    const auto& st = cpuMeter.getStats();
+    if (st.numBlocks == 0) return "CPU : no blocks processed";
+
+    auto percent = [](float x) { return juce::String(x * 100.0f, 1) + "%"; };
+    juce::String text = "CPU : mean " + percent(st.mean) + " / p95 " + percent(st.p95) + " / p99 " + percent(st.p99)
+        + " / max " + percent(st.max) + " / overruns " + juce::String(st.overruns);
+
+    static const char* stageNames[CpuStage::NumStages] = { "Dry", "Up", "Core", "Down", "Mix" };
+    float shareSum = 0.0f;
+    for (float share : st.stageShare) shareSum += share;
+    if (shareSum > 0.0f) {
+        text << "  ---  ";
+        for (int s = 0; s < CpuStage::NumStages; ++s) {
+            if (s > 0) text << " ";
+            text << stageNames[s] << " " << juce::String(juce::roundToInt(st.stageShare[(size_t)s] * 100.0f)) << "%";
+        }
+    }
+    return text;
+}
+
+// Points the band editor at one band; the new attachments load its values
+void NextGenSaturationAudioProcessorEditor::showBand(int band) {
+    editedBand = band;
+    bandSelectButtons[(size_t)band].setToggleState(true, juce::dontSendNotification);
+
+    const juce::String id = "band" + juce::String(band + 1);
+    bandTypeAtt.reset();
+    bandDriveAtt.reset();
+    bandCharAtt.reset();
+    bandTypeAtt = std::make_unique<ComboAtt>(audioProcessor.apvts, id + "Type", bandTypeCombo);
+    bandDriveAtt = std::make_unique<SliderAtt>(audioProcessor.apvts, id + "Drive", bandDriveSlider);
+    bandCharAtt = std::make_unique<SliderAtt>(audioProcessor.apvts, id + "Character", bandCharSlider);
+
+    bandTypeCombo.nameJP = "Band " + juce::String(band + 1) + " Algorithm";
+    bandDriveSlider.nameJP = "Band " + juce::String(band + 1) + " Drive";
+    bandCharSlider.nameJP = "Band " + juce::String(band + 1) + " Char";
+}
+
+// Dims the crossovers and bands the current mode does not use
+void NextGenSaturationAudioProcessorEditor::updateBandControls() {
+    const int numBands = juce::jlimit(1, maxBands, (int)bandsValue->load() + 1);
+    if (numBands == shownNumBands) return;
+    shownNumBands = numBands;
+
+    auto enable = [](juce::Component& c, bool on) {
+        c.setEnabled(on);
+        c.setAlpha(on ? 1.0f : 0.4f);
+    };
+    for (int k = 0; k < maxBands - 1; ++k) enable(crossoverSliders[(size_t)k], k < numBands - 1);
+    for (int b = 0; b < maxBands; ++b) enable(bandSelectButtons[(size_t)b], numBands > 1 && b < numBands);
+    enable(bandTypeCombo, numBands > 1);
+    enable(bandDriveSlider, numBands > 1);
+    enable(bandCharSlider, numBands > 1);
+
+    if (editedBand >= numBands) showBand(0);
+}
+
 void NextGenSaturationAudioProcessorEditor::updateKnobProperties(int satType) {
     juce::String charName = "Char";
     juce::String charDesc = "";
@@ -3,6 +3,7 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyser.h"
 
 // ... (AbletonLookAndFeel, InfoBarCombo, InfoBarButton, VisualizerComponent are same as before) ...
 // ... (Please refer to previous PluginEditor.h for these classes) ...
@@ -119,34 +120,40 @@ public:
 // ==============================================================================
 class VisualizerComponent : public juce::Component {
 public:
-    void setProcessor(NextGenSaturationAudioProcessor* p) { processor = p; }
+    VisualizerComponent() {
+        inputDecimator.setSamplesPerBucket(samplesPerBucket);
+        outputDecimator.setSamplesPerBucket(samplesPerBucket);
+    }
+
+    // Telemetry streams as read from the processor (message thread)
+    void push(const float* const* streams, int numSamples) {
+        if (history.empty()) return;
+
+        // Both decimators run in lockstep: a bucket pair per history column
+        using Processor = NextGenSaturationAudioProcessor;
+        int numIn = 0, numOut = 0;
+        inputDecimator.process(streams[Processor::telemetryInput], numSamples,
+            [&](const TelemetryBucket& b) { history[(size_t)wrap(writePos + pendingColumns + numIn++)].input = b; });
+        outputDecimator.process(streams[Processor::telemetryOutput], numSamples,
+            [&](const TelemetryBucket& b) { history[(size_t)wrap(writePos + pendingColumns + numOut++)].output = b; });
+        pendingColumns += numIn;
+    }
 
     void update() {
-        if (!processor) return;
-
-        int start1, size1, start2, size2;
-        processor->scopeFifo.prepareToRead(1024, start1, size1, start2, size2);
-
-        if (size1 + size2 > 0) {
-            if (size1 > 0) {
-                for (int i = 0; i < size1; ++i) {
-                    inputBuffer.add(processor->scopeDataInput[start1 + i]);
-                    outputBuffer.add(processor->scopeDataOutput[start1 + i]);
-                }
-            }
-            if (size2 > 0) {
-                for (int i = 0; i < size2; ++i) {
-                    inputBuffer.add(processor->scopeDataInput[start2 + i]);
-                    outputBuffer.add(processor->scopeDataOutput[start2 + i]);
-                }
-            }
-            processor->scopeFifo.finishedRead(size1 + size2);
-
-            while (inputBuffer.size() > 256) inputBuffer.remove(0);
-            while (outputBuffer.size() > 256) outputBuffer.remove(0);
-
-            repaint();
-        }
+        if (pendingColumns == 0) return;
+
+        writePos = wrap(writePos + pendingColumns);
+        scrollIn(pendingColumns);
+        pendingColumns = 0;
+        repaint();
+    }
+
+    void resized() override {
+        const int w = juce::jmax(1, getWidth());
+        history.assign((size_t)w, {});
+        writePos = 0;
+        pendingColumns = 0;
+        scopeImage = juce::Image(juce::Image::ARGB, w, juce::jmax(1, getHeight()), true);
     }
 
     void paint(juce::Graphics& g) override {
@@ -154,41 +161,269 @@ public:
 
         g.setColour(juce::Colour(0xFF222222));
         g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+        if (scopeImage.isValid()) g.drawImageAt(scopeImage, 0, 0);
         g.setColour(juce::Colours::grey);
         g.drawRect(getLocalBounds(), 1);
 
-        if (inputBuffer.isEmpty()) return;
+        // Level change through the plugin over the visible window
+        double inSum = 0.0, outSum = 0.0;
+        for (const auto& c : history) {
+            inSum += (double)c.input.rms * c.input.rms;
+            outSum += (double)c.output.rms * c.output.rms;
+        }
+        const double n = (double)juce::jmax((size_t)1, history.size());
+        const float inRms = (float)std::sqrt(inSum / n), outRms = (float)std::sqrt(outSum / n);
+        if (inRms > 0.001f && outRms > 0.0f) {
+            g.setColour(juce::Colours::lightgrey);
+            g.setFont(11.0f);
+            g.drawText(juce::String(juce::Decibels::gainToDecibels(outRms / inRms), 1) + " dB",
+                getLocalBounds().reduced(6, 3), juce::Justification::topRight, false);
+        }
+    }
 
-        float w = (float)getWidth();
-        float h = (float)getHeight();
-        float mid = h * 0.5f;
-        float scaleX = w / (float)inputBuffer.size();
+private:
+    static constexpr int samplesPerBucket = 8;
+
+    // One history column per pixel column, oldest at writePos
+    struct Column { TelemetryBucket input, output; };
+
+    int wrap(int i) const { return i % (int)history.size(); }
+
+    // Shifts the cached image left by the new columns and draws only those
+    void scrollIn(int numNew) {
+        const int w = scopeImage.getWidth(), h = scopeImage.getHeight();
+        numNew = juce::jmin(numNew, w);
+        if (numNew < w) scopeImage.moveImageSection(0, 0, numNew, 0, w - numNew, h);
+        scopeImage.clear({ w - numNew, 0, numNew, h });
+
+        juce::Graphics g(scopeImage);
+        const float mid = h * 0.5f, scaleY = mid * 0.8f;
+        for (int x = w - numNew; x < w; ++x) {
+            const int age = w - 1 - x;
+            const auto& c = history[(size_t)wrap(writePos - 1 - age + w)];
+            const auto& prev = history[(size_t)wrap(writePos - 2 - age + 2 * w)];
+            drawColumn(g, x, c.input, prev.input, mid, scaleY, juce::Colours::grey.withAlpha(0.5f));
+            drawColumn(g, x, c.output, prev.output, mid, scaleY, juce::Colour(0xFFFF764D));
+        }
+    }
+
+    // The bucket's min..max, stretched to meet the previous column so the trace stays joined
+    static void drawColumn(juce::Graphics& g, int x, const TelemetryBucket& b, const TelemetryBucket& prev,
+                           float mid, float scaleY, juce::Colour colour) {
+        const float hi = std::max(b.max, prev.min), lo = std::min(b.min, prev.max);
+        g.setColour(colour);
+        g.drawVerticalLine(x, mid - hi * scaleY, mid - lo * scaleY + 1.0f);
+    }
+
+    TelemetryDecimator inputDecimator, outputDecimator;
+    std::vector<Column> history;
+    int writePos = 0, pendingColumns = 0;
+    juce::Image scopeImage;   // the scrolled trace, transparent background
+};
 
-        g.setColour(juce::Colours::grey.withAlpha(0.5f));
-        juce::Path pIn;
-        pIn.startNewSubPath(0, mid - inputBuffer[0] * mid * 0.8f);
-        for (int i = 1; i < inputBuffer.size(); ++i) {
-            pIn.lineTo((float)i * scaleX, mid - inputBuffer[i] * mid * 0.8f);
+// ==============================================================================
+// 4. Spectrum Analyzer
+// ==============================================================================
+class SpectrumComponent : public juce::Component {
+public:
+    void setSampleRate(double newRate) {
+        if (newRate > 0.0 && newRate != sampleRate) {
+            sampleRate = newRate;
+            columnBins.clear();
         }
-        g.strokePath(pIn, juce::PathStrokeType(1.0f));
+    }
 
+    // Output telemetry as read from the processor (message thread)
+    void push(const float* samples, int numSamples) { analyser.push(samples, numSamples); }
+
+    // Throttled: at most frameRateHz repaints a second, and only for a new spectrum
+    void update() {
+        const auto now = juce::Time::getMillisecondCounter();
+        if (now - lastFrameMs < 1000u / frameRateHz) return;
+        if (!analyser.fetch(spectrum)) return;
+        lastFrameMs = now;
+        repaint();
+    }
+
+    void resized() override { columnBins.clear(); }
+
+    void paint(juce::Graphics& g) override {
+        if (getWidth() <= 0 || getHeight() <= 0) return;
+
+        g.setColour(juce::Colour(0xFF222222));
+        g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+        const float w = (float)getWidth();
+        const float h = (float)getHeight();
+        const float maxHz = (float)(sampleRate * 0.5);
+
+        g.setFont(10.0f);
+        for (float hz : { 100.0f, 1000.0f, 10000.0f }) {
+            if (hz >= maxHz) continue;
+            const float x = w * std::log(hz / minHz) / std::log(maxHz / minHz);
+            g.setColour(juce::Colours::grey.withAlpha(0.3f));
+            g.drawVerticalLine((int)x, 0.0f, h);
+            g.setColour(juce::Colours::grey);
+            g.drawText(hz >= 1000.0f ? juce::String((int)(hz / 1000.0f)) + "k" : juce::String((int)hz),
+                (int)x + 3, (int)h - 14, 30, 12, juce::Justification::left, false);
+        }
+
+        if (spectrum.size() != (size_t)SpectrumAnalyser::numBins) {
+            g.setColour(juce::Colours::grey);
+            g.drawRect(getLocalBounds(), 1);
+            return;
+        }
+        if (columnBins.size() != (size_t)getWidth() + 1) buildColumnBins();
+
+        // Each pixel column shows the loudest bin it covers, so narrow harmonics stay visible
+        auto toY = [h](float db) { return juce::jmap(juce::jlimit(bottomDB, topDB, db), bottomDB, topDB, h, 0.0f); };
+        juce::Path p;
+        p.startNewSubPath(0.0f, h);
+        for (int x = 0; x < getWidth(); ++x) {
+            float db = SpectrumAnalyser::floorDB;
+            for (int bin = columnBins[(size_t)x]; bin < columnBins[(size_t)x + 1]; ++bin) db = std::max(db, spectrum[(size_t)bin]);
+            p.lineTo((float)x, toY(db));
+        }
+        p.lineTo(w, h);
+        p.closeSubPath();
+
+        g.setColour(juce::Colour(0xFFFF764D).withAlpha(0.3f));
+        g.fillPath(p);
         g.setColour(juce::Colour(0xFFFF764D));
-        juce::Path pOut;
-        pOut.startNewSubPath(0, mid - outputBuffer[0] * mid * 0.8f);
-        for (int i = 1; i < outputBuffer.size(); ++i) {
-            pOut.lineTo((float)i * scaleX, mid - outputBuffer[i] * mid * 0.8f);
+        g.strokePath(p, juce::PathStrokeType(1.0f));
+
+        g.setColour(juce::Colours::grey);
+        g.drawRect(getLocalBounds(), 1);
+    }
+
+private:
+    static constexpr unsigned int frameRateHz = 20;
+    static constexpr float minHz = 20.0f;
+    static constexpr float topDB = 0.0f, bottomDB = -100.0f;
+
+    // Log-spaced bin range [columnBins[x], columnBins[x + 1]) per pixel column, at least one bin wide
+    void buildColumnBins() {
+        const int w = getWidth();
+        const double maxHz = sampleRate * 0.5;
+        const double binHz = sampleRate / SpectrumAnalyser::fftSize;
+        columnBins.resize((size_t)w + 1);
+        for (int x = 0; x <= w; ++x) {
+            const double hz = minHz * std::pow(maxHz / minHz, (double)x / w);
+            columnBins[(size_t)x] = juce::jlimit(0, SpectrumAnalyser::numBins - 1, (int)std::round(hz / binHz));
+        }
+        for (int x = 0; x < w; ++x)
+            columnBins[(size_t)x + 1] = juce::jlimit(columnBins[(size_t)x] + 1, SpectrumAnalyser::numBins, columnBins[(size_t)x + 1]);
+    }
+
+    SpectrumAnalyser analyser;
+    std::vector<float> spectrum;
+    std::vector<int> columnBins;
+    double sampleRate = 48000.0;
+    juce::uint32 lastFrameMs = 0;
+};
+
+// ==============================================================================
+// 5. Transfer Curve
+// ==============================================================================
+// The selected algorithm's static curve (evaluateCurve), input -1..1 across,
+// output -1..1 up. The path is rebuilt only when type, drive, character or
+// the size change.
+class TransferCurveComponent : public juce::Component {
+public:
+    void setParameters(int type, float driveDB, float character) {
+        if (type == curveType && driveDB == curveDrive && character == curveCharacter) return;
+        curveType = type;
+        curveDrive = driveDB;
+        curveCharacter = character;
+        rebuild();
+        repaint();
+    }
+
+    void resized() override { rebuild(); }
+
+    void paint(juce::Graphics& g) override {
+        if (getWidth() <= 0 || getHeight() <= 0) return;
+
+        const auto bounds = getLocalBounds().toFloat();
+        g.setColour(juce::Colour(0xFF222222));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        g.setColour(juce::Colours::grey.withAlpha(0.3f));
+        g.drawVerticalLine(getWidth() / 2, 0.0f, bounds.getHeight());
+        g.drawHorizontalLine(getHeight() / 2, 0.0f, bounds.getWidth());
+        g.drawLine(0.0f, bounds.getHeight(), bounds.getWidth(), 0.0f, 1.0f);
+
+        {
+            juce::Graphics::ScopedSaveState clip(g);
+            g.reduceClipRegion(getLocalBounds());
+            g.setColour(juce::Colour(0xFFFF764D));
+            g.strokePath(curvePath, juce::PathStrokeType(1.5f));
+        }
+
+        g.setColour(juce::Colours::grey);
+        g.drawRect(getLocalBounds(), 1);
+    }
+
+private:
+    static constexpr int numPoints = 256;
+
+    void rebuild() {
+        curvePath.clear();
+        if (getWidth() <= 0 || getHeight() <= 0 || curveType < 0) return;
+
+        std::array<double, numPoints> x, y;
+        for (int i = 0; i < numPoints; ++i) x[(size_t)i] = -1.0 + 2.0 * i / (numPoints - 1);
+        evaluateCurve(curveType, curveDrive, curveCharacter, x.data(), y.data(), numPoints);
+
+        const float w = (float)getWidth(), h = (float)getHeight();
+        for (int i = 0; i < numPoints; ++i) {
+            const float px = (float)(x[(size_t)i] + 1.0) * 0.5f * w;
+            const float py = (float)(1.0 - juce::jlimit(-2.0, 2.0, y[(size_t)i])) * 0.5f * h;
+            if (i == 0) curvePath.startNewSubPath(px, py);
+            else curvePath.lineTo(px, py);
         }
-        g.strokePath(pOut, juce::PathStrokeType(2.0f));
+    }
+
+    int curveType = -1;
+    float curveDrive = 0.0f, curveCharacter = 0.0f;
+    juce::Path curvePath;
+};
+
+// ==============================================================================
+// 6. CPU Meter
+// ==============================================================================
+// Mean and p99 load from the processor's CpuLoadMeter, next to the quality
+// combos; turns to the accent colour once a block has missed its deadline.
+class CpuMeterComponent : public juce::Component {
+public:
+    void setStats(const CpuLoadMeter::Stats& s) {
+        stats = s;
+        if (s.overruns > 0) overrunHold = overrunHoldWindows;
+        else if (overrunHold > 0) --overrunHold;
+        repaint();
+    }
+
+    const CpuLoadMeter::Stats& getStats() const { return stats; }
+
+    void paint(juce::Graphics& g) override {
+        juce::String text = "CPU --";
+        if (stats.numBlocks > 0)
+            text = "CPU " + juce::String(juce::roundToInt(stats.mean * 100.0f)) + "% / p99 " + juce::String(juce::roundToInt(stats.p99 * 100.0f)) + "%";
+
+        g.setFont(juce::Font("Meiryo UI", 11.0f, juce::Font::bold));
+        g.setColour(overrunHold > 0 ? juce::Colour(0xFFFF764D) : juce::Colours::grey);
+        g.drawText(text, getLocalBounds(), juce::Justification::centred, false);
     }
 
 private:
-    NextGenSaturationAudioProcessor* processor = nullptr;
-    juce::Array<float> inputBuffer;
-    juce::Array<float> outputBuffer;
+    static constexpr int overrunHoldWindows = 6;   // keep the warning up for a few seconds
+
+    CpuLoadMeter::Stats stats;
+    int overrunHold = 0;
 };
 
 // ==============================================================================
-// 4. Main Editor Class
+// 7. Main Editor Class
 // ==============================================================================
 class NextGenSaturationAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
@@ -203,6 +438,14 @@ private:
     void timerCallback() override;
     void updateInfoBar(const juce::String& text);
     void updateKnobProperties(int satType);
+    juce::String getLatencyInfo() const;
+    juce::String getCpuInfo() const;
+    void showBand(int band);
+    void updateBandControls();
+
+    static constexpr int analyserHeight = 110;
+    static constexpr int stripHeight = 120;    // multiband and processing controls
+    static constexpr int cpuStatsTicks = 16;   // timer ticks per CPU statistics window (~0.5 s)
 
     NextGenSaturationAudioProcessor& audioProcessor;
     AbletonLookAndFeel abletonLnF;
@@ -219,7 +462,12 @@ private:
     AbletonKnob driveSlider;
     AbletonKnob charSlider;
     InfoBarCombo qualityCombo;
+    InfoBarCombo osFilterCombo;
+    CpuMeterComponent cpuMeter;
+    int cpuStatsCounter = 0;
     VisualizerComponent visualizer;
+    SpectrumComponent spectrum;
+    TransferCurveComponent transferCurve;
 
     AbletonKnob postLowCutSlider;
     AbletonKnob postHighCutSlider;
@@ -229,6 +477,21 @@ private:
     AbletonKnob outputGainSlider;
     InfoBarButton safetyClipButton;
 
+    // Multiband: one editor for the selected band, re-attached on selection
+    static constexpr int maxBands = NextGenSaturationAudioProcessor::maxBands;
+    InfoBarCombo bandsCombo;
+    std::array<AbletonKnob, maxBands - 1> crossoverSliders;
+    std::array<InfoBarButton, maxBands> bandSelectButtons;
+    InfoBarCombo bandTypeCombo;
+    AbletonKnob bandDriveSlider;
+    AbletonKnob bandCharSlider;
+    int editedBand = 0;
+    int shownNumBands = -1;
+
+    InfoBarCombo mathTierCombo;
+    InfoBarCombo adaaOrderCombo;
+    juce::Rectangle<int> multibandArea, processingArea;
+
     juce::Label infoBar;
     int infoBarHoldCounter = 0;
 
@@ -241,11 +504,18 @@ private:
     std::vector<std::unique_ptr<SliderAtt>> sliderAtts;
     std::vector<std::unique_ptr<ComboAtt>> comboAtts;
     std::vector<std::unique_ptr<ButtonAtt>> buttonAtts;
+    std::unique_ptr<ComboAtt> bandTypeAtt;
+    std::unique_ptr<SliderAtt> bandDriveAtt, bandCharAtt;
 
-    void addKnob(AbletonKnob& knob, const juce::String& paramID, const juce::String& labelText, const juce::String& suffix, const juce::String& descJP);
-    void addCombo(InfoBarCombo& box, const juce::String& paramID, const juce::String& descJP);
+    void addKnob(AbletonKnob& knob, const juce::String& paramID, const juce::String& labelText, const juce::String& suffix, const juce::String& descJP, bool attach = true);
+    void addCombo(InfoBarCombo& box, const juce::String& paramID, const juce::String& descJP, bool attach = true);
     void addButton(InfoBarButton& btn, const juce::String& paramID, const juce::String& nameJP, const juce::String& descJP);
 
+    std::atomic<float>* satTypeValue = nullptr;
+    std::atomic<float>* driveValue = nullptr;
+    std::atomic<float>* characterValue = nullptr;
+    std::atomic<float>* bandsValue = nullptr;
+
     juce::Component* lastHoveredComp = nullptr;
     int lastSatType = -1;
 
@@ -9,18 +9,31 @@ NextGenSaturationAudioProcessor::NextGenSaturationAudioProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
     apvts(*this, &undoManager, "Parameters", createParameterLayout())
 {
-    scopeDataInput.resize(scopeSize, 0.0f);
-    scopeDataOutput.resize(scopeSize, 0.0f);
-    updateOversampler(1, 512);
+    params.attach(apvts);
+
+    inputGainParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("inputGain"));
+    outputGainParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("outputGain"));
+    autoGainParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("autoGain"));
+
+    prepareOversamplers(512);
+    dryCompensator.prepare(numDspChannels, maxLatencySamples, 512);
+    switchQuality(1, OsFilter::LinearPhase, false);
+    setLatencySamples(pendingLatency.exchange(-1));
+
+    startTimerHz(30);
 }
 
-NextGenSaturationAudioProcessor::~NextGenSaturationAudioProcessor() {}
+NextGenSaturationAudioProcessor::~NextGenSaturationAudioProcessor()
+{
+    stopTimer();
+}
 
 bool NextGenSaturationAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo()) return false;
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo()) return false;
-    return true;
+    // Any layout up to maxChannels, as long as input and output match
+    const auto& out = layouts.getMainOutputChannelSet();
+    if (out.isDisabled() || out.size() > maxChannels) return false;
+    return layouts.getMainInputChannelSet() == out;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout NextGenSaturationAudioProcessor::createParameterLayout()
@@ -51,8 +64,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout NextGenSaturationAudioProces
     createFloat("drive", "Drive", 0.0f, 24.0f, 0.0f);
     createFloat("character", "Character", 0.0f, 1.0f, 0.5f);
 
-    juce::StringArray osQualities{ "Off", "2x", "4x", "8x", "16x (Ultra)" };
+    juce::StringArray osQualities{ "Off", "2x", "4x", "8x", "16x (Ultra)", "Auto" };
     params.push_back(std::make_unique<juce::AudioParameterChoice>("quality", "Quality", osQualities, 1));
+    juce::StringArray osFilters{ "Linear Phase", "IIR", "Min Latency" };
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("osFilter", "OS Filter", osFilters, 0));
 
     createFreq("postLowCut", "Post Low Cut", 20.0f);
     createFreq("postHighCut", "Post High Cut", 20000.0f);
@@ -63,26 +78,52 @@ juce::AudioProcessorValueTreeState::ParameterLayout NextGenSaturationAudioProces
     createFloat("outputGain", "Output", -18.0f, 18.0f, 0.0f);
     params.push_back(std::make_unique<juce::AudioParameterBool>("safetyClip", "Safety Clipper", true));
 
+    juce::StringArray mathTiers{ "Auto", "Exact", "Fast" };
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("mathTier", "Precision", mathTiers, 0));
+
+    // ADAA 2 reaches the next oversampling stage's alias rejection for one
+    // more sample of saturator delay at the DSP rate
+    juce::StringArray adaaOrders{ "ADAA 1", "ADAA 2" };
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("adaaOrder", "Anti-Aliasing", adaaOrders, 0));
+
+    // Multiband: LR4 crossovers, each band with its own algorithm ("Main"
+    // follows satType) and drive/character offsets from the main controls
+    juce::StringArray bandModes{ "Off", "2 Bands", "3 Bands", "4 Bands" };
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("bands", "Bands", bandModes, 0));
+    const float crossoverDefaults[maxBands - 1] = { 200.0f, 1500.0f, 6000.0f };
+    for (int k = 0; k < maxBands - 1; ++k)
+        createFreq("crossover" + juce::String(k + 1), "Crossover " + juce::String(k + 1), crossoverDefaults[k]);
+
+    juce::StringArray bandTypes{ "Main" };
+    bandTypes.addArray(satTypes);
+    for (int b = 0; b < maxBands; ++b) {
+        const juce::String id = "band" + juce::String(b + 1), name = "Band " + juce::String(b + 1);
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(id + "Type", name + " Algorithm", bandTypes, 0));
+        createFloat(id + "Drive", name + " Drive", -24.0f, 24.0f, 0.0f);
+        createFloat(id + "Character", name + " Character", -1.0f, 1.0f, 0.0f);
+    }
+
     return { params.begin(), params.end() };
 }
 
 void NextGenSaturationAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    lastDspSampleRate = 0.0;
-    visSkipCounter = 0;
+    numDspChannels = juce::jlimit(1, maxChannels, getTotalNumOutputChannels());
 
-    preLowL.prepare(sampleRate); preLowR.prepare(sampleRate);
-    preHighL.prepare(sampleRate); preHighR.prepare(sampleRate);
-    postLowL.prepare(sampleRate); postLowR.prepare(sampleRate);
-    postHighL.prepare(sampleRate); postHighR.prepare(sampleRate);
+    // Every quality stage up front, so switching never allocates
+    prepareOversamplers(samplesPerBlock);
+    const float maxLatency = *std::max_element(maxStageLatency.begin(), maxStageLatency.end());
+    for (auto& aligner : wetAligners) aligner.prepare(numDspChannels, (int)std::ceil(maxLatency) + 1, samplesPerBlock);
+    for (auto& bank : groupBanks) bank.resize((size_t)numChannelGroups(numDspChannels));
 
-    satCoreL.reset(); satCoreR.reset();
-    satCoreL.prepare(sampleRate);
-    satCoreR.prepare(sampleRate);
+    // Worst case: 16x oversampling
+    satScratch.assign((size_t)samplesPerBlock * 16, ChannelVector(0.0));
+    bandScratch.assign(satScratch.size() * (maxBands - 1), ChannelVector(0.0));
+    wetBuffer.setSize(numDspChannels, samplesPerBlock);
+    fadeBuffer.setSize(numDspChannels, samplesPerBlock);
+    dryBuffer.setSize(numDspChannels, samplesPerBlock);
 
-    dryDelayL.prepare({ sampleRate, (juce::uint32)samplesPerBlock, 1 });
-    dryDelayR.prepare({ sampleRate, (juce::uint32)samplesPerBlock, 1 });
-    dryDelayL.setMaximumDelayInSamples(16384);
+    dryCompensator.prepare(numDspChannels, maxLatencySamples, samplesPerBlock);
 
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -96,52 +137,201 @@ void NextGenSaturationAudioProcessor::prepareToPlay(double sampleRate, int sampl
     s_outputGain.reset(sampleRate, 0.05);
     s_preLow.reset(sampleRate, 0.05); s_preHigh.reset(sampleRate, 0.05);
     s_postLow.reset(sampleRate, 0.05); s_postHigh.reset(sampleRate, 0.05);
-
-    int quality = (int)apvts.getRawParameterValue("quality")->load();
-    updateOversampler(quality, samplesPerBlock);
-
+    for (auto& s : s_crossover) s.reset(sampleRate, 0.05);
+    for (auto& s : s_bandDrive) s.reset(sampleRate, 0.05);
+    for (auto& s : s_bandCharacter) s.reset(sampleRate, 0.05);
+
+    activeQuality = -1;
+    fadeRemaining = 0;
+    fadeLength = juce::roundToInt(sampleRate * qualityFadeSeconds);
+
+    adaptiveQuality.prepare(sampleRate);
+    const int quality = (int)params.load(ParamId::quality);
+    switchQuality(quality == autoQualityChoice ? 0 : quality, (int)params.load(ParamId::osFilter), quality == autoQualityChoice);
+    params.markAllChanged();
+    setLatencySamples(pendingLatency.exchange(-1)); // not on the audio thread here
+
+    autoGainAnalyser.prepare(sampleRate, numDspChannels, autoGainSeconds);
+    cpuMeter.prepare(sampleRate);
     agWasLearning = false;
     isAutoGainLearning = false;
+
+    silentSamples = 0;
+    idleHoldSamples = (int64_t)(sampleRate * idleHoldSeconds);
+    lastOutputPeak = 0.0f;
+    isIdle = false;
+}
+
+void NextGenSaturationAudioProcessor::prepareOversamplers(int samplesPerBlock)
+{
+    using OS = juce::dsp::Oversampling<DspSample>;
+
+    for (int f = 0; f < numOsFilters; ++f) {
+        // Linear phase: equiripple FIR half-bands. The IIR families use
+        // polyphase all-pass half-bands (minimum-phase-like, a few samples of
+        // delay); Min Latency relaxes their transition band and stopband.
+        const auto type = (f == OsFilter::LinearPhase) ? OS::filterHalfBandFIREquiripple : OS::filterHalfBandPolyphaseIIR;
+        const bool maxQuality = (f != OsFilter::MinLatency);
+
+        auto& bank = oversamplers[(size_t)f];
+        for (int q = 1; q < numQualities; ++q) {
+            bank[(size_t)q] = std::make_unique<OS>((size_t)numDspChannels, q, type, maxQuality);
+            bank[(size_t)q]->initProcessing((size_t)samplesPerBlock);
+        }
+
+        maxStageLatency[(size_t)f] = 0.0f;
+        for (int q = 0; q < numQualities; ++q) maxStageLatency[(size_t)f] = std::max(maxStageLatency[(size_t)f], getStageLatency(q, f));
+    }
+}
+
+double NextGenSaturationAudioProcessor::getDspSampleRate(int quality) const
+{
+    const auto* os = oversamplers[0][(size_t)quality].get();
+    return getSampleRate() * (os ? (double)os->getOversamplingFactor() : 1.0);
+}
+
+float NextGenSaturationAudioProcessor::getStageLatency(int quality, int filter) const
+{
+    filter = juce::jlimit(0, numOsFilters - 1, filter);
+    if (quality == autoQualityChoice) return maxStageLatency[(size_t)filter];
+
+    const auto* os = oversamplers[(size_t)filter][(size_t)juce::jlimit(0, numQualities - 1, quality)].get();
+    return os ? (float)os->getLatencyInSamples() : 0.0f;
+}
+
+void NextGenSaturationAudioProcessor::prepareGroupBank(std::vector<ChannelGroup>& bank, int quality)
+{
+    const double dspSampleRate = getDspSampleRate(quality);
+    for (auto& group : bank) {
+        group.preLow.prepare(dspSampleRate); group.preHigh.prepare(dspSampleRate);
+        group.postLow.prepare(dspSampleRate); group.postHigh.prepare(dspSampleRate);
+
+        group.satCore.prepare(dspSampleRate);
+        group.satCore.reset();
+        group.crossover.prepare(dspSampleRate);
+        for (auto& core : group.bandCores) {
+            core.prepare(dspSampleRate);
+            core.reset();
+        }
+    }
 }
 
-void NextGenSaturationAudioProcessor::updateOversampler(int qualityID, int samplesPerBlock)
+// Realtime safe: the stage already exists, only its state is cleared. The
+// outgoing stage keeps running on the other bank until the crossfade ends.
+// When only the latency hold changes (Auto settling on the running stage),
+// the stage keeps its state and bank: running both banks through the same
+// oversampler would interleave two signals through one filter history.
+void NextGenSaturationAudioProcessor::switchQuality(int qualityID, int filterID, bool holdMaxLatency)
 {
-    if (currentQuality == qualityID) return;
-    currentQuality = qualityID;
+    qualityID = juce::jlimit(0, numQualities - 1, qualityID);
+    filterID = juce::jlimit(0, numOsFilters - 1, filterID);
+
+    const bool sameStage = activeQuality == qualityID && (activeFilter == filterID || qualityID == 0);   // Off has no filters
+    const bool crossfade = activeQuality >= 0 && fadeLength > 0;
+    if (crossfade && !sameStage) {
+        fadingQuality = activeQuality;
+        fadingFilter = activeFilter;
+        fadeRemaining = fadeLength;
+        activeBank = 1 - activeBank;
+    }
 
-    if (qualityID == 0) {
-        oversampler.reset();
-        setLatencySamples(0);
+    activeQuality = qualityID;
+    activeFilter = filterID;
+    activeHoldsMaxLatency = holdMaxLatency;
+    if (!sameStage) {
+        if (auto* os = oversamplers[(size_t)filterID][(size_t)qualityID].get()) os->reset();
+        prepareGroupBank(groupBanks[(size_t)activeBank], qualityID);
+    }
+
+    // With the latency held, the stage's output is delayed up to the slowest
+    // one. A running stage glides to its new delay along with the dry path.
+    const float stageLatency = getStageLatency(qualityID, filterID);
+    const float pathLatency = holdMaxLatency ? maxStageLatency[(size_t)filterID] : stageLatency;
+    auto& aligner = wetAligners[(size_t)activeBank];
+    if (sameStage) {
+        aligner.setLatency(pathLatency - stageLatency, crossfade ? fadeLength : 0);
     }
     else {
-        oversampler = std::make_unique<juce::dsp::Oversampling<float>>(2, qualityID, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true);
-        oversampler->initProcessing(samplesPerBlock);
-        setLatencySamples(oversampler->getLatencyInSamples());
+        aligner.setLatency(pathLatency - stageLatency);
+        aligner.reset();
+    }
+
+    // The dry path follows the new latency over the same crossfade, and is what
+    // gets reported to the host (from the message thread, see timerCallback)
+    dryCompensator.setLatency(pathLatency, crossfade ? fadeLength : 0);
+    pendingLatency.store(dryCompensator.getLatencySamples());
+}
+
+// Message thread: host notifications the audio thread has queued up
+void NextGenSaturationAudioProcessor::timerCallback()
+{
+    const int latency = pendingLatency.exchange(-1);
+    if (latency >= 0 && latency != getLatencySamples()) setLatencySamples(latency);
+
+    AutoGainAnalyser::Result result;
+    if (!autoGainAnalyser.fetchResult(result)) return;
+
+    // The analyser measured the input before the input gain and the output
+    // after the output gain, so both are referred to the current settings
+    const float inputDB = inputGainParam != nullptr ? inputGainParam->get() : 0.0f;
+    const float outputDB = outputGainParam != nullptr ? outputGainParam->get() : 0.0f;
+    const float ceilingDB = -0.1f;
+
+    float appliedInputDB = inputDB;
+    if (result.inputTruePeakDB + inputDB > ceilingDB && inputGainParam != nullptr) {
+        appliedInputDB = ceilingDB - result.inputTruePeakDB;
+        inputGainParam->beginChangeGesture();
+        inputGainParam->setValueNotifyingHost(inputGainParam->convertTo0to1(appliedInputDB));
+        inputGainParam->endChangeGesture();
+    }
+
+    // Gated loudness below the absolute gate means nothing was measured
+    if (result.inputLoudness > LoudnessMeter::absoluteGate && result.outputLoudness > LoudnessMeter::absoluteGate && outputGainParam != nullptr) {
+        // The input gain cut is assumed to carry through the saturation 1:1
+        const double diffDB = result.inputLoudness + inputDB - result.outputLoudness - (appliedInputDB - inputDB);
+        const float newOutDB = juce::jlimit(-18.0f, 18.0f, outputDB + (float)diffDB);
+        outputGainParam->beginChangeGesture();
+        outputGainParam->setValueNotifyingHost(outputGainParam->convertTo0to1(newOutDB));
+        outputGainParam->endChangeGesture();
+    }
+
+    if (autoGainParam != nullptr) {
+        autoGainParam->beginChangeGesture();
+        autoGainParam->setValueNotifyingHost(0.0f);
+        autoGainParam->endChangeGesture();
     }
 }
 
-void NextGenSaturationAudioProcessor::updateDspParameters()
+// Retargets only the smoothers whose parameter changed in this block's snapshot
+void NextGenSaturationAudioProcessor::updateDspParameters(ParamMask changed)
 {
-    float inGain = *apvts.getRawParameterValue("inputGain");
-    float drv = *apvts.getRawParameterValue("drive");
-    float chr = *apvts.getRawParameterValue("character");
-    float mx = *apvts.getRawParameterValue("mix");
-    float outGain = *apvts.getRawParameterValue("outputGain");
-
-    s_inputGain.setTargetValue(juce::Decibels::decibelsToGain(inGain));
-    s_drive.setTargetValue(drv);
-    s_character.setTargetValue(chr);
-    s_mix.setTargetValue(mx * 0.01f);
-    s_outputGain.setTargetValue(juce::Decibels::decibelsToGain(outGain));
-
-    s_preLow.setTargetValue(*apvts.getRawParameterValue("preLowCut"));
-    s_preHigh.setTargetValue(*apvts.getRawParameterValue("preHighCut"));
-    s_postLow.setTargetValue(*apvts.getRawParameterValue("postLowCut"));
-    s_postHigh.setTargetValue(*apvts.getRawParameterValue("postHighCut"));
+    if (changed & paramBit(ParamId::inputGain)) s_inputGain.setTargetValue(juce::Decibels::decibelsToGain(params.inputGain()));
+    if (changed & paramBit(ParamId::drive)) s_drive.setTargetValue(params.drive());
+    if (changed & paramBit(ParamId::character)) s_character.setTargetValue(params.character());
+    if (changed & paramBit(ParamId::mix)) s_mix.setTargetValue(params.mix() * 0.01f);
+    if (changed & paramBit(ParamId::outputGain)) s_outputGain.setTargetValue(juce::Decibels::decibelsToGain(params.outputGain()));
+
+    if (changed & paramBit(ParamId::preLowCut)) s_preLow.setTargetValue(params.preLowCut());
+    if (changed & paramBit(ParamId::preHighCut)) s_preHigh.setTargetValue(params.preHighCut());
+    if (changed & paramBit(ParamId::postLowCut)) s_postLow.setTargetValue(params.postLowCut());
+    if (changed & paramBit(ParamId::postHighCut)) s_postHigh.setTargetValue(params.postHighCut());
+
+    if (changed & paramBits(ParamId::crossover1, maxBands - 1)) {
+        for (int k = 0; k < maxBands - 1; ++k) s_crossover[(size_t)k].setTargetValue(params.crossover(k));
+    }
+    if (changed & paramBits(ParamId::band1Type, maxBands * ParamId::bandStride)) {
+        for (int b = 0; b < maxBands; ++b) {
+            s_bandDrive[(size_t)b].setTargetValue(params.bandDrive(b));
+            s_bandCharacter[(size_t)b].setTargetValue(params.bandCharacter(b));
+        }
+    }
 }
 
 void NextGenSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    // Nothing below may allocate or lock (checked with NGS_REALTIME_CHECKS=1)
+    RealtimeChecks::RealtimeScope realtimeScope;
+    CpuLoadMeter::BlockScope cpuScope(cpuMeter, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -149,302 +339,360 @@ void NextGenSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    updateDspParameters();
+    // One snapshot of every parameter per block
+    updateDspParameters(params.capture());
 
-    bool isBypassed = *apvts.getRawParameterValue("bypass") > 0.5f;
+    bool isBypassed = params.bypass();
     if (isBypassed) {
         float inG = s_inputGain.getTargetValue();
         buffer.applyGain(inG);
 
-        // FIX: Initialize variables
-        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-        scopeFifo.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
-        const float* dL = buffer.getReadPointer(0);
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            if (++visSkipCounter >= 8) {
-                visSkipCounter = 0;
-                if (size1 > 0) {
-                    if (start1 < scopeSize) {
-                        scopeDataInput[start1] = dL[i];
-                        scopeDataOutput[start1] = dL[i];
-                    }
-                    start1++; size1--;
-                }
-                else if (size2 > 0) {
-                    if (start2 < scopeSize) {
-                        scopeDataInput[start2] = dL[i];
-                        scopeDataOutput[start2] = dL[i];
-                    }
-                    start2++; size2--;
-                }
-            }
-        }
-        scopeFifo.finishedWrite(buffer.getNumSamples() / 8);
+        const float* scope[numTelemetryStreams] = { buffer.getReadPointer(0), buffer.getReadPointer(0) };
+        telemetry.push(scope, buffer.getNumSamples());
         return;
     }
 
-    int quality = (int)*apvts.getRawParameterValue("quality");
-    updateOversampler(quality, buffer.getNumSamples());
-
-    int postSlopeIdx = (int)*apvts.getRawParameterValue("postSlope");
-    HighPrecisionFilter::Slope postSlope = (HighPrecisionFilter::Slope)postSlopeIdx;
-    int satType = (int)*apvts.getRawParameterValue("satType");
-    bool safety = *apvts.getRawParameterValue("safetyClip") > 0.5f;
-
-    bool isLearning = *apvts.getRawParameterValue("autoGain") > 0.5f;
-    isAutoGainLearning.store(isLearning);
-
-    if (isLearning) {
-        if (!agWasLearning) {
-            agWasLearning = true;
-            agRmsSumIn = 0.0;
-            agRmsSumOut = 0.0;
-            agMaxPeakIn = 0.0;
-            agSampleCountIn = 0;
-            agSampleCountOut = 0;
-            agTotalSamplesProcessed = 0;
-            agTargetSamples = (int64_t)(getSampleRate() * 3.0);
+    int postSlopeIdx = params.postSlope();
+    ChannelFilter::Slope postSlope = (ChannelFilter::Slope)postSlopeIdx;
+    int satType = params.satType();
+    bool safety = params.safetyClip();
+
+    const int numChannels = std::min(buffer.getNumChannels(), numDspChannels);
+    const int hostSamples = buffer.getNumSamples();
+
+    // Quality changes take effect at a block boundary, one switch at a time.
+    // Auto picks the stage from this block's input and holds the latency at
+    // the slowest stage, so switching never moves the reported latency.
+    int quality = params.quality();
+    const bool autoQuality = quality == autoQualityChoice;
+    if (autoQuality) {
+        const auto analysis = AdaptiveQualitySelector::analyse(buffer.getArrayOfReadPointers(), numChannels, hostSamples);
+        const float inGain = s_inputGain.getCurrentValue(), driveDB = s_drive.getCurrentValue(), character = s_character.getCurrentValue();
+        const int numBands = juce::jlimit(1, maxBands, params.bands() + 1);
+        int wanted = (numBands == 1) ? adaptiveQuality.estimateStage(satType, analysis, inGain, driveDB, character) : 0;
+
+        // Multiband: the most demanding band sets the stage
+        for (int b = 0; numBands > 1 && b < numBands; ++b) {
+            const int type = params.bandType(b);
+            wanted = std::max(wanted, adaptiveQuality.estimateStage(type == 0 ? satType : type - 1, analysis, inGain,
+                driveDB + s_bandDrive[(size_t)b].getCurrentValue(), juce::jlimit(0.0f, 1.0f, character + s_bandCharacter[(size_t)b].getCurrentValue())));
         }
+        quality = adaptiveQuality.update(wanted, hostSamples);
     }
-    else {
-        agWasLearning = false;
+    const int osFilter = params.osFilter();
+    const bool filterChanged = osFilter != activeFilter && (quality > 0 || autoQuality);   // Off has no filters
+    const bool stageChanged = quality != activeQuality || filterChanged || autoQuality != activeHoldsMaxLatency;
+    if (stageChanged && fadeRemaining == 0) switchQuality(quality, osFilter, autoQuality);
+
+    // A finished measurement waits for the message thread to switch AutoGain off
+    const bool agPending = autoGainAnalyser.hasResult();
+    bool isLearning = !agPending && params.autoGain();
+    isAutoGainLearning.store(isLearning || agPending);
+
+    if (isLearning != agWasLearning && !agPending) {
+        // Switched on: a fresh session; switched off early: drop the partial one
+        if (isLearning) autoGainAnalyser.startSession();
+        else autoGainAnalyser.cancelSession();
+    }
+    agWasLearning = isLearning;
+
+    // Idle: once the input has been silent long enough for every internal
+    // state to have decayed, the whole chain is skipped and outputs silence.
+    // The state is left as it settled (a biased shape keeps its DC blocker
+    // charged to f(0)), so the first block after the silence just continues.
+    // A parameter change wakes the chain, so a new bias decays as it would
+    // have without idling instead of stepping in on resume.
+    float inputPeak = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch) inputPeak = std::max(inputPeak, buffer.getMagnitude(ch, 0, hostSamples));
+    const bool inputSilent = inputPeak < silenceThreshold;
+    silentSamples = inputSilent ? silentSamples + hostSamples : 0;
+
+    if (!inputSilent || params.getChanged() != 0) {
+        isIdle = false;
+    }
+    else if (!isIdle && silentSamples >= idleHoldSamples && lastOutputPeak < silenceThreshold && fadeRemaining == 0 && !isLearning) {
+        isIdle = true;
     }
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::AudioBlock<float> wetBlock = block;
-    juce::dsp::AudioBlock<float> upsampledBlock;
-
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
-
-    if (isLearning) {
-        const float* inL = dryBuffer.getReadPointer(0);
-        const float* inR = (dryBuffer.getNumChannels() > 1) ? dryBuffer.getReadPointer(1) : nullptr;
-        double threshold = 0.001;
-
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            float sL = inL[i];
-            float sR = (inR) ? inR[i] : sL;
-            float gain = s_inputGain.getCurrentValue();
-            sL *= gain; sR *= gain;
+    if (isIdle) {
+        processIdleBlock(buffer, hostSamples);
+        return;
+    }
 
-            double peak = std::max(std::abs(sL), std::abs(sR));
-            if (peak > agMaxPeakIn) agMaxPeakIn = peak;
+    {
+        CpuLoadMeter::StageScope stage(cpuMeter, CpuStage::DryCopy);
+        dryBuffer.makeCopyOf(buffer, true);
+    }
 
-            if (std::abs(sL) > threshold) { agRmsSumIn += (double)sL * sL; agSampleCountIn++; }
-            if (std::abs(sR) > threshold) { agRmsSumIn += (double)sR * sR; agSampleCountIn++; }
+    // Smoothed parameters advance at the host rate and become per-block ramps
+    // shared by every channel group (and by both stages during a crossfade)
+    WetRamps ramps;
+    ramps.inputGain = { s_inputGain.getCurrentValue(), s_inputGain.skip(hostSamples) };
+    ramps.preLow = { s_preLow.getCurrentValue(), s_preLow.skip(hostSamples) };
+    ramps.preHigh = { s_preHigh.getCurrentValue(), s_preHigh.skip(hostSamples) };
+    ramps.postLow = { s_postLow.getCurrentValue(), s_postLow.skip(hostSamples) };
+    ramps.postHigh = { s_postHigh.getCurrentValue(), s_postHigh.skip(hostSamples) };
+    ramps.saturation.driveDB = { s_drive.getCurrentValue(), s_drive.skip(hostSamples) };
+    ramps.saturation.character = { s_character.getCurrentValue(), s_character.skip(hostSamples) };
+    ramps.postSlope = postSlope;
+    ramps.satType = satType;
+
+    // Auto: exact math for offline renders, the table tier in realtime
+    int mathTier = params.mathTier();
+    ramps.mathTier = (mathTier == 0) ? (isNonRealtime() ? MathTier::Exact : MathTier::Fast) : mathTier - 1;
+    ramps.adaaOrder = params.adaaOrder();
+    makeBandRamps(ramps, hostSamples);
+
+    // The wet path runs in DspSample from here to the downsampler
+    wetBuffer.makeCopyOf(buffer, true);
+    processWetPath(activeQuality, activeFilter, groupBanks[(size_t)activeBank], wetBuffer, numChannels, ramps);
+    alignWetPath(activeBank, wetBuffer, numChannels);
+
+    if (fadeRemaining > 0) {
+        // Quality switch: run the outgoing stage too and crossfade the wet
+        // signal (the dry compensator fades its delay over the same span)
+        fadeBuffer.makeCopyOf(buffer, true);
+        processWetPath(fadingQuality, fadingFilter, groupBanks[(size_t)(1 - activeBank)], fadeBuffer, numChannels, ramps);
+        alignWetPath(1 - activeBank, fadeBuffer, numChannels);
+
+        const int fadeStart = fadeLength - fadeRemaining;
+        const DspSample invLength = (DspSample)1 / (DspSample)fadeLength;
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto* wet = wetBuffer.getWritePointer(ch);
+            const auto* old = fadeBuffer.getReadPointer(ch);
+            for (int i = 0; i < hostSamples; ++i) {
+                const DspSample a = std::min((DspSample)1, (DspSample)(fadeStart + i + 1) * invLength);
+                wet[i] = old[i] + a * (wet[i] - old[i]);
+            }
         }
-    }
 
-    float latency = (oversampler) ? oversampler->getLatencyInSamples() : 0.0f;
+        fadeRemaining = std::max(0, fadeRemaining - hostSamples);
+    }
 
     {
-        auto* dryL = dryBuffer.getWritePointer(0);
-        auto* dryR = dryBuffer.getWritePointer(1);
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            dryDelayL.pushSample(0, dryL[i]);
-            dryDelayR.pushSample(0, dryR[i]);
-            dryL[i] = dryDelayL.popSample(0, latency);
-            dryR[i] = dryDelayR.popSample(0, latency);
-        }
+        CpuLoadMeter::StageScope stage(cpuMeter, CpuStage::DryCopy);
+        dryCompensator.process(dryBuffer.getArrayOfWritePointers(), numChannels, hostSamples);
     }
 
-    if (oversampler) {
-        upsampledBlock = oversampler->processSamplesUp(block);
-        wetBlock = upsampledBlock;
+    CpuLoadMeter::StageScope mixStage(cpuMeter, CpuStage::Mix);
+    float* const* out = buffer.getArrayOfWritePointers();
+    const DspSample* const* wet = wetBuffer.getArrayOfReadPointers();
+    const float* const* dry = dryBuffer.getArrayOfReadPointers();
+
+    if (!s_mix.isSmoothing() && !s_outputGain.isSmoothing()) {
+        // Settled mix and output gain: constant weights, one pass per channel
+        const float mix = s_mix.getTargetValue();
+        const float outG = s_outputGain.getTargetValue();
+        const float dryGain = (1.0f - mix) * outG;
+        const float wetGain = mix * outG;
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            for (int i = 0; i < hostSamples; ++i) {
+                float mixed = dry[ch][i] * dryGain + (float)wet[ch][i] * wetGain;
+                if (safety) mixed = juce::jlimit(-1.0f, 1.0f, mixed);
+                out[ch][i] = mixed;
+            }
+        }
     }
+    else {
+        for (int i = 0; i < hostSamples; ++i) {
+            float mix = s_mix.getNextValue();
+            float outG = s_outputGain.getNextValue();
 
-    auto numSamples = wetBlock.getNumSamples();
-    auto* ptrL = wetBlock.getChannelPointer(0);
-    auto* ptrR = wetBlock.getChannelPointer(1);
-
-    double dspSampleRate = getSampleRate() * (oversampler ? oversampler->getOversamplingFactor() : 1.0);
+            for (int ch = 0; ch < numChannels; ++ch) {
+                float mixed = dry[ch][i] * (1.0f - mix) + (float)wet[ch][i] * mix;
+                mixed *= outG;
 
-    if (std::abs(dspSampleRate - lastDspSampleRate) > 1.0) {
-        lastDspSampleRate = dspSampleRate;
-        preLowL.prepare(dspSampleRate); preLowR.prepare(dspSampleRate);
-        preHighL.prepare(dspSampleRate); preHighR.prepare(dspSampleRate);
-        postLowL.prepare(dspSampleRate); postLowR.prepare(dspSampleRate);
-        postHighL.prepare(dspSampleRate); postHighR.prepare(dspSampleRate);
+                if (safety) mixed = juce::jlimit(-1.0f, 1.0f, mixed);
 
-        satCoreL.prepare(dspSampleRate);
-        satCoreR.prepare(dspSampleRate);
-        satCoreL.reset(); satCoreR.reset();
+                out[ch][i] = mixed;
+            }
+        }
     }
 
-    int updateCounter = 0;
-
-    for (size_t i = 0; i < numSamples; ++i) {
-        float inG = s_inputGain.getNextValue();
-        float drv = s_drive.getNextValue();
-        float chr = s_character.getNextValue();
-        double preLC = s_preLow.getNextValue();
-        double preHC = s_preHigh.getNextValue();
-        double postLC = s_postLow.getNextValue();
-        double postHC = s_postHigh.getNextValue();
+    // Scope follows the first channel
+    const float* scope[numTelemetryStreams] = { dry[0], out[0] };
+    telemetry.push(scope, hostSamples);
 
-        if (updateCounter == 0) {
-            preLowL.setParams(HighPrecisionFilter::HighPass, preLC, HighPrecisionFilter::Slope12dB);
-            preLowR.setParams(HighPrecisionFilter::HighPass, preLC, HighPrecisionFilter::Slope12dB);
-            preHighL.setParams(HighPrecisionFilter::LowPass, preHC, HighPrecisionFilter::Slope12dB);
-            preHighR.setParams(HighPrecisionFilter::LowPass, preHC, HighPrecisionFilter::Slope12dB);
+    // Delay-compensated input (before the input gain) and the final output
+    if (isLearning) autoGainAnalyser.push(dry, out, numChannels, hostSamples);
 
-            postLowL.setParams(HighPrecisionFilter::HighPass, postLC, postSlope);
-            postLowR.setParams(HighPrecisionFilter::HighPass, postLC, postSlope);
-            postHighL.setParams(HighPrecisionFilter::LowPass, postHC, postSlope);
-            postHighR.setParams(HighPrecisionFilter::LowPass, postHC, postSlope);
-        }
-        updateCounter = (updateCounter + 1) & 7;
+    // Only needed to decide on idling
+    lastOutputPeak = 0.0f;
+    if (inputSilent) {
+        for (int ch = 0; ch < numChannels; ++ch) lastOutputPeak = std::max(lastOutputPeak, buffer.getMagnitude(ch, 0, hostSamples));
+    }
+}
 
-        double xL = (double)ptrL[i] * inG;
-        double xR = (double)ptrR[i] * inG;
+// Silence out; parameters and scope keep moving
+void NextGenSaturationAudioProcessor::processIdleBlock(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    buffer.clear();
 
-        xL = preLowL.process(xL);
-        xR = preLowR.process(xR);
-        xL = preHighL.process(xL);
-        xR = preHighR.process(xR);
+    s_inputGain.skip(numSamples); s_drive.skip(numSamples); s_character.skip(numSamples);
+    s_mix.skip(numSamples); s_outputGain.skip(numSamples);
+    s_preLow.skip(numSamples); s_preHigh.skip(numSamples);
+    s_postLow.skip(numSamples); s_postHigh.skip(numSamples);
+    for (auto& s : s_crossover) s.skip(numSamples);
+    for (auto& s : s_bandDrive) s.skip(numSamples);
+    for (auto& s : s_bandCharacter) s.skip(numSamples);
 
-        xL = satCoreL.process(xL, satType, drv, chr);
-        xR = satCoreR.process(xR, satType, drv, chr);
+    telemetry.pushSilence(numSamples);
+}
 
-        xL = postLowL.process(xL);
-        xR = postLowR.process(xR);
-        xL = postHighL.process(xL);
-        xR = postHighR.process(xR);
+void NextGenSaturationAudioProcessor::alignWetPath(int bank, juce::AudioBuffer<DspSample>& wet, int numChannels)
+{
+    auto& aligner = wetAligners[(size_t)bank];
+    if (aligner.getLatency() > 0.0f) aligner.process(wet.getArrayOfWritePointers(), numChannels, wet.getNumSamples());
+}
 
-        ptrL[i] = (float)xL;
-        ptrR[i] = (float)xR;
-    }
+void NextGenSaturationAudioProcessor::processWetPath(int quality, int filter, std::vector<ChannelGroup>& bank, juce::AudioBuffer<DspSample>& wet, int numChannels, const WetRamps& ramps)
+{
+    auto* oversampler = oversamplers[(size_t)filter][(size_t)quality].get();
 
+    juce::dsp::AudioBlock<DspSample> block = juce::dsp::AudioBlock<DspSample>(wet).getSubsetChannelBlock(0, (size_t)numChannels);
+    juce::dsp::AudioBlock<DspSample> wetBlock = block;
     if (oversampler) {
-        oversampler->processSamplesDown(block);
+        CpuLoadMeter::StageScope stage(cpuMeter, CpuStage::Upsample);
+        wetBlock = oversampler->processSamplesUp(block);
     }
 
-    auto* outL = buffer.getWritePointer(0);
-    auto* outR = buffer.getWritePointer(1);
-    const auto* dL = dryBuffer.getReadPointer(0);
-    const auto* dR = dryBuffer.getReadPointer(1);
-
-    float localMaxIn = 0.0f;
-    float localMaxOut = 0.0f;
+    const int n = (int)wetBlock.getNumSamples();
+    jassert((size_t)n <= satScratch.size());
+    ChannelVector* sat = satScratch.data();
 
-    // FIX: Initialize variables
-    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-    scopeFifo.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+    const DspSample inGainStep = (DspSample)((ramps.inputGain.end - ramps.inputGain.start) / std::max(1, n));
 
-    if (isLearning) {
-        double threshold = 0.001;
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            float mix = s_mix.getCurrentValue();
-            float wetL = outL[i];
-            float wetR = outR[i];
-            float mixedL = dL[i] * (1.0f - mix) + wetL * mix;
-            float mixedR = dR[i] * (1.0f - mix) + wetR * mix;
+    DspSample* channelPtrs[maxChannels] = {};
+    for (int ch = 0; ch < numChannels; ++ch) channelPtrs[ch] = wetBlock.getChannelPointer((size_t)ch);
 
-            if (std::abs(mixedL) > threshold) { agRmsSumOut += (double)mixedL * mixedL; agSampleCountOut++; }
-            if (std::abs(mixedR) > threshold) { agRmsSumOut += (double)mixedR * mixedR; agSampleCountOut++; }
-        }
-
-        agTotalSamplesProcessed += buffer.getNumSamples();
-
-        if (agTotalSamplesProcessed >= agTargetSamples) {
-            double rmsIn = (agSampleCountIn > 0) ? std::sqrt(agRmsSumIn / agSampleCountIn) : 0.0;
-            double rmsOut = (agSampleCountOut > 0) ? std::sqrt(agRmsSumOut / agSampleCountOut) : 0.0;
+    for (size_t g = 0; g < bank.size(); ++g) {
+        auto& group = bank[g];
+        const int first = (int)g * ChannelVector::numLanes;
+        if (first >= numChannels) break;
 
-            double targetPeak = 0.9885; // -0.1 dB
-            if (agMaxPeakIn > targetPeak) {
-                double peakDiffDB = juce::Decibels::gainToDecibels(agMaxPeakIn) - (-0.1);
-                float newInputDB = 0.0f - (float)peakDiffDB;
+        CpuLoadMeter::StageScope stage(cpuMeter, CpuStage::Core);
+        packChannelGroup(channelPtrs, numChannels, first, sat, n);
 
-                if (auto* p = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("inputGain"))) {
-                    p->beginChangeGesture();
-                    p->setValueNotifyingHost(p->convertTo0to1(newInputDB));
-                    p->endChangeGesture();
-                }
+        // Input gain (a settled gain is a loop invariant, unity is skipped)
+        if (!ramps.inputGain.isConstant()) {
+            DspSample inG = (DspSample)ramps.inputGain.start;
+            for (int i = 0; i < n; ++i) {
+                inG += inGainStep;
+                sat[i] *= ChannelVector(inG);
             }
+        }
+        else if (ramps.inputGain.start != 1.0) {
+            const ChannelVector inG((DspSample)ramps.inputGain.start);
+            for (int i = 0; i < n; ++i) sat[i] *= inG;
+        }
 
-            if (rmsIn > 0.0001 && rmsOut > 0.0001) {
-                double ratio = rmsIn / rmsOut;
-                double dbDiff = juce::Decibels::gainToDecibels(ratio);
+        // Pre filters
+        group.preLow.setParams(ChannelFilter::HighPass, ChannelFilter::Slope12dB, ramps.preLow, n);
+        group.preHigh.setParams(ChannelFilter::LowPass, ChannelFilter::Slope12dB, ramps.preHigh, n);
+        group.preLow.processBlock(sat, n);
+        group.preHigh.processBlock(sat, n);
 
-                float newOutDB = (float)dbDiff;
-                newOutDB = juce::jlimit(-18.0f, 18.0f, newOutDB);
+        // Saturation: every channel of the group in one pass (drive/character ramp across the block)
+        group.crossover.setParams(ramps.numBands, ramps.crossovers.data(), n);
+        if (ramps.numBands > 1) {
+            processBands(group, sat, n, ramps);
+        }
+        else {
+            group.satCore.setAlgorithm(ramps.satType);
+            group.satCore.setMathTier(ramps.mathTier);
+            group.satCore.setAdaaOrder(ramps.adaaOrder);
+            group.satCore.processBlock(sat, sat, n, ramps.saturation);
+        }
 
-                if (auto* p = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("outputGain"))) {
-                    p->beginChangeGesture();
-                    p->setValueNotifyingHost(p->convertTo0to1(newOutDB));
-                    p->endChangeGesture();
-                }
-            }
+        // Post filters
+        group.postLow.setParams(ChannelFilter::HighPass, ramps.postSlope, ramps.postLow, n);
+        group.postHigh.setParams(ChannelFilter::LowPass, ramps.postSlope, ramps.postHigh, n);
+        group.postLow.processBlock(sat, n);
+        group.postHigh.processBlock(sat, n);
 
-            if (auto* p = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("autoGain"))) {
-                p->beginChangeGesture();
-                p->setValueNotifyingHost(0.0f);
-                p->endChangeGesture();
-            }
-        }
+        unpackChannelGroup(sat, channelPtrs, numChannels, first, n);
     }
 
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-        float mix = s_mix.getNextValue();
-        float outG = s_outputGain.getNextValue();
+    if (oversampler) {
+        CpuLoadMeter::StageScope stage(cpuMeter, CpuStage::Downsample);
+        oversampler->processSamplesDown(block);
+    }
+}
 
-        float wetL = outL[i];
-        float wetR = outR[i];
+// Splits the group into its bands (band 0 in place), saturates each with its
+// own core and sums them back into sat
+void NextGenSaturationAudioProcessor::processBands(ChannelGroup& group, ChannelVector* sat, int n, const WetRamps& ramps)
+{
+    const size_t stride = satScratch.size();
+    ChannelVector* bands[maxBands] = { sat };
+    for (int b = 1; b < ramps.numBands; ++b) bands[b] = bandScratch.data() + stride * (size_t)(b - 1);
+
+    group.crossover.process(sat, bands, n);
+
+    for (int b = 0; b < ramps.numBands; ++b) {
+        auto& core = (b == 0) ? group.satCore : group.bandCores[(size_t)(b - 1)];
+        core.setAlgorithm(ramps.bandTypes[(size_t)b]);
+        core.setMathTier(ramps.mathTier);
+        core.setAdaaOrder(ramps.adaaOrder);
+        core.processBlock(bands[b], bands[b], n, ramps.bandSaturation[(size_t)b]);
+    }
 
-        float mixedL = dL[i] * (1.0f - mix) + wetL * mix;
-        float mixedR = dR[i] * (1.0f - mix) + wetR * mix;
+    for (int b = 1; b < ramps.numBands; ++b) {
+        const ChannelVector* band = bands[b];
+        for (int i = 0; i < n; ++i) sat[i] += band[i];
+    }
+}
 
-        mixedL *= outG;
-        mixedR *= outG;
+// Per-band drive/character are offsets from the main controls; the
+// crossovers are kept a third of an octave apart and in ascending order
+void NextGenSaturationAudioProcessor::makeBandRamps(WetRamps& ramps, int hostSamples)
+{
+    ramps.numBands = juce::jlimit(1, maxBands, params.bands() + 1);
+
+    constexpr double minSpacing = 1.26;
+    ValueRamp previous{ 0.0, 0.0 };
+    for (int k = 0; k < maxBands - 1; ++k) {
+        auto& s = s_crossover[(size_t)k];
+        const double start = s.getCurrentValue(), end = s.skip(hostSamples);
+        ramps.crossovers[(size_t)k] = { std::max(start, previous.start * minSpacing), std::max(end, previous.end * minSpacing) };
+        previous = ramps.crossovers[(size_t)k];
+    }
 
-        if (safety) {
-            mixedL = juce::jlimit(-1.0f, 1.0f, mixedL);
-            mixedR = juce::jlimit(-1.0f, 1.0f, mixedR);
-        }
+    const auto& mainDrive = ramps.saturation.driveDB;
+    const auto& mainCharacter = ramps.saturation.character;
+    for (int b = 0; b < maxBands; ++b) {
+        auto& drive = s_bandDrive[(size_t)b];
+        auto& character = s_bandCharacter[(size_t)b];
+        const double driveStart = drive.getCurrentValue(), driveEnd = drive.skip(hostSamples);
+        const double charStart = character.getCurrentValue(), charEnd = character.skip(hostSamples);
 
-        outL[i] = mixedL;
-        outR[i] = mixedR;
-
-        if (++visSkipCounter >= 8) {
-            visSkipCounter = 0;
-            if (size1 > 0) {
-                if (start1 < scopeSize) {
-                    scopeDataInput[start1] = dL[i];
-                    scopeDataOutput[start1] = mixedL;
-                }
-                start1++; size1--;
-            }
-            else if (size2 > 0) {
-                if (start2 < scopeSize) {
-                    scopeDataInput[start2] = dL[i];
-                    scopeDataOutput[start2] = mixedL;
-                }
-                start2++; size2--;
-            }
-        }
+        auto& band = ramps.bandSaturation[(size_t)b];
+        band.driveDB = { mainDrive.start + driveStart, mainDrive.end + driveEnd };
+        band.character = { juce::jlimit(0.0, 1.0, mainCharacter.start + charStart), juce::jlimit(0.0, 1.0, mainCharacter.end + charEnd) };
 
-        localMaxIn = std::max(localMaxIn, std::abs(dL[i]));
-        localMaxOut = std::max(localMaxOut, std::abs(mixedL));
+        const int type = params.bandType(b);
+        ramps.bandTypes[(size_t)b] = (type == 0) ? ramps.satType : type - 1;
     }
-
-    scopeFifo.finishedWrite(buffer.getNumSamples() / 8);
-
-    currentInputRMS.store(std::max(currentInputRMS.load() * 0.9f, localMaxIn));
-    currentOutputRMS.store(std::max(currentOutputRMS.load() * 0.9f, localMaxOut));
 }
 
 const juce::String NextGenSaturationAudioProcessor::getName() const { return JucePlugin_Name; }
 bool NextGenSaturationAudioProcessor::acceptsMidi() const { return false; }
 bool NextGenSaturationAudioProcessor::producesMidi() const { return false; }
 bool NextGenSaturationAudioProcessor::isMidiEffect() const { return false; }
-double NextGenSaturationAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double NextGenSaturationAudioProcessor::getTailLengthSeconds() const
+{
+    // Filter ringing after the input stops, plus the time to get through the chain
+    const double sampleRate = getSampleRate();
+    return decayTailSeconds + (sampleRate > 0.0 ? getLatencySamples() / sampleRate : 0.0);
+}
 int NextGenSaturationAudioProcessor::getNumPrograms() { return 1; }
 int NextGenSaturationAudioProcessor::getCurrentProgram() { return 0; }
 void NextGenSaturationAudioProcessor::setCurrentProgram(int index) {}
 const juce::String NextGenSaturationAudioProcessor::getProgramName(int index) { return {}; }
 void NextGenSaturationAudioProcessor::changeProgramName(int index, const juce::String& newName) {}
-void NextGenSaturationAudioProcessor::releaseResources() {}
+void NextGenSaturationAudioProcessor::releaseResources() { autoGainAnalyser.release(); }
 bool NextGenSaturationAudioProcessor::hasEditor() const { return true; }
 juce::AudioProcessorEditor* NextGenSaturationAudioProcessor::createEditor() { return new NextGenSaturationAudioProcessorEditor(*this); }
 void NextGenSaturationAudioProcessor::getStateInformation(juce::MemoryBlock& destData) {
@@ -456,4 +704,161 @@ void NextGenSaturationAudioProcessor::setStateInformation(const void* data, int
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr) apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
 }
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() { return new NextGenSaturationAudioProcessor(); }
\ No newline at end of file
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() { return new NextGenSaturationAudioProcessor(); }
+#if NGS_REALTIME_CHECKS
+// ==============================================================================
+// Realtime check hooks: replacement allocation functions, the C heap below
+// them and pthread_mutex_lock on Linux, reporting calls made inside a
+// RealtimeScope
+// ==============================================================================
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+// operator new/delete report once; the C heap call underneath runs suspended
+namespace {
+    void* checkedAlloc(std::size_t size) {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        RealtimeChecks::SuspendScope suspend;
+        if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+        throw std::bad_alloc();
+    }
+
+    void* checkedAlignedAlloc(std::size_t size, std::size_t alignment) {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        RealtimeChecks::SuspendScope suspend;
+       #if JUCE_WINDOWS
+        if (void* p = _aligned_malloc(size == 0 ? 1 : size, alignment)) return p;
+       #else
+        size = (size + alignment - 1) / alignment * alignment;
+        if (void* p = std::aligned_alloc(alignment, size == 0 ? alignment : size)) return p;
+       #endif
+        throw std::bad_alloc();
+    }
+
+    void checkedFree(void* p) {
+        if (p == nullptr) return;
+        RealtimeChecks::report(RealtimeChecks::Deallocation);
+        RealtimeChecks::SuspendScope suspend;
+        std::free(p);
+    }
+
+    void checkedAlignedFree(void* p) {
+        if (p == nullptr) return;
+        RealtimeChecks::report(RealtimeChecks::Deallocation);
+        RealtimeChecks::SuspendScope suspend;
+       #if JUCE_WINDOWS
+        _aligned_free(p);
+       #else
+        std::free(p);
+       #endif
+    }
+}
+
+void* operator new(std::size_t size) { return checkedAlloc(size); }
+void* operator new[](std::size_t size) { return checkedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { try { return checkedAlloc(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { try { return checkedAlloc(size); } catch (...) { return nullptr; } }
+void* operator new(std::size_t size, std::align_val_t al) { return checkedAlignedAlloc(size, (std::size_t)al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return checkedAlignedAlloc(size, (std::size_t)al); }
+
+void operator delete(void* p) noexcept { checkedFree(p); }
+void operator delete[](void* p) noexcept { checkedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { checkedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { checkedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { checkedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { checkedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { checkedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { checkedAlignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { checkedAlignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { checkedAlignedFree(p); }
+
+#if JUCE_LINUX && defined(__GLIBC__)
+// The C heap: glibc exports its allocator under __libc_* names, so the
+// replacements forward there without dlsym (which itself calls calloc)
+extern "C" {
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void __libc_free(void*);
+    void* __libc_memalign(std::size_t, std::size_t);
+
+    void* malloc(std::size_t size) noexcept {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) noexcept {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* p, std::size_t size) noexcept {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        return __libc_realloc(p, size);
+    }
+
+    void free(void* p) noexcept {
+        if (p != nullptr) RealtimeChecks::report(RealtimeChecks::Deallocation);
+        __libc_free(p);
+    }
+
+    void* memalign(std::size_t alignment, std::size_t size) noexcept {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept {
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+        RealtimeChecks::report(RealtimeChecks::Allocation);
+        void* p = __libc_memalign(alignment, size);
+        if (p == nullptr) return ENOMEM;
+        *out = p;
+        return 0;
+    }
+}
+#endif
+
+#if JUCE_WINDOWS && defined(_DEBUG)
+ #include <crtdbg.h>
+
+// The C heap: every malloc/realloc/free of the debug CRT passes this hook
+namespace {
+    int crtAllocHook(int allocType, void*, std::size_t, int blockType, long, const unsigned char*, int) {
+        if (blockType == _CRT_BLOCK) return TRUE;   // the CRT's own bookkeeping
+        RealtimeChecks::report(allocType == _HOOK_FREE ? RealtimeChecks::Deallocation : RealtimeChecks::Allocation);
+        return TRUE;
+    }
+
+    struct CrtAllocHookInstaller {
+        CrtAllocHookInstaller() { _CrtSetAllocHook(crtAllocHook); }
+    } crtAllocHookInstaller;
+}
+#endif
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+// Interposes the libc symbol; the real one is resolved lazily through RTLD_NEXT
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFn = int (*)(pthread_mutex_t*);
+    static std::atomic<LockFn> realLock{ nullptr };
+
+    LockFn fn = realLock.load(std::memory_order_acquire);
+    if (fn == nullptr) {
+        fn = (LockFn)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        realLock.store(fn, std::memory_order_release);
+    }
+
+    RealtimeChecks::report(RealtimeChecks::MutexLock);
+    return fn(mutex);
+}
+#endif
+#endif
@@ -3,8 +3,14 @@
 #pragma once
 #include <JuceHeader.h>
 #include "DspEngine.h"
-
-class NextGenSaturationAudioProcessor : public juce::AudioProcessor
+#include "RealtimeChecks.h"
+#include "ParameterSnapshot.h"
+#include "LoudnessAnalysis.h"
+#include "TelemetryRing.h"
+#include "CpuLoadMeter.h"
+
+class NextGenSaturationAudioProcessor : public juce::AudioProcessor,
+                                        private juce::Timer
 {
 public:
     NextGenSaturationAudioProcessor();
@@ -36,54 +42,146 @@ public:
     juce::UndoManager undoManager;
     juce::AudioProcessorValueTreeState apvts;
 
-    static constexpr int scopeSize = 1024;
-    juce::AbstractFifo scopeFifo{ scopeSize };
-    std::vector<float> scopeDataInput;
-    std::vector<float> scopeDataOutput;
+    // Largest main bus accepted (9.1.6)
+    static constexpr int maxChannels = 16;
 
-    std::atomic<float> currentInputRMS{ 0.0f };
-    std::atomic<float> currentOutputRMS{ 0.0f };
+    // Multiband mode ("bands" parameter: Off, 2, 3 or 4 bands)
+    static constexpr int maxBands = ChannelCrossover::maxBands;
 
-    std::atomic<bool> isAutoGainLearning{ false };
+    // --- Oversampling ---
+    static constexpr int numQualities = 5;
+    static constexpr int autoQualityChoice = numQualities;  // "Auto" entry of the quality parameter
 
-private:
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    // Half-band filter family of the oversampler ("osFilter" parameter)
+    static constexpr int numOsFilters = 3;
+    struct OsFilter { enum Id : int { LinearPhase = 0, Iir, MinLatency }; };
+
+    // Latency in host samples of a quality/filter stage (Auto: the slowest
+    // stage of that family). Valid once the stages are built.
+    float getStageLatency(int quality, int filter) const;
+
+    // Scope telemetry: the first channel's input and output, written once per
+    // block and only while an editor is subscribed
+    enum TelemetryStream { telemetryInput = 0, telemetryOutput, numTelemetryStreams };
+    TelemetryRing<numTelemetryStreams> telemetry{ 1 << 15 };
 
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
-    int currentQuality = -1;
-    double lastDspSampleRate = 0.0;
+    std::atomic<bool> isAutoGainLearning{ false };
 
-    // Filters
-    HighPrecisionFilter preLowL, preLowR;
-    HighPrecisionFilter preHighL, preHighR;
-    HighPrecisionFilter postLowL, postLowR;
-    HighPrecisionFilter postHighL, postHighR;
+    // processBlock's own wall time against the buffer duration
+    CpuLoadMeter cpuMeter;
 
-    // Saturation Engines
-    SaturationCore satCoreL, satCoreR;
+private:
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Dry Signal Delay Compensation
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> dryDelayL, dryDelayR;
+    // Cached parameter handles plus the per-block snapshot and change mask
+    ParameterSnapshot params;
+
+    // Host-side parameter objects that AutoGain writes back to
+    juce::AudioParameterFloat* inputGainParam = nullptr;
+    juce::AudioParameterFloat* outputGainParam = nullptr;
+    juce::AudioParameterBool* autoGainParam = nullptr;
+
+    // --- Oversampler Bank ---
+    // Every quality stage of every filter family is built in prepareToPlay;
+    // the audio thread only switches between them. [f][0] (Off) stays empty.
+    static constexpr double qualityFadeSeconds = 0.02;
+
+    using OversamplerBank = std::array<std::unique_ptr<juce::dsp::Oversampling<DspSample>>, numQualities>;
+    std::array<OversamplerBank, numOsFilters> oversamplers;   // [filter][quality]
+    std::array<float, numOsFilters> maxStageLatency{};
+    int activeQuality = -1, activeFilter = 0;
+    int fadingQuality = -1, fadingFilter = 0;   // outgoing stage while a switch crossfades
+    int fadeRemaining = 0;
+    int fadeLength = 0;
+
+    // Auto quality: the stage follows the signal, the latency stays at the
+    // slowest stage's and each bank delays its stage's output up to it
+    AdaptiveQualitySelector adaptiveQuality;
+    bool activeHoldsMaxLatency = false;
+    std::array<BasicLatencyCompensator<DspSample>, 2> wetAligners;
+
+    // One oversampler serves every channel; the DSP chain runs per channel group
+    int numDspChannels = 2;
+
+    // satCore is the full-band core and band 0 of the multiband mode
+    struct ChannelGroup {
+        ChannelFilter preLow, preHigh;
+        ChannelFilter postLow, postHigh;
+        ChannelSaturationCore satCore;
+        ChannelCrossover crossover;
+        std::array<ChannelSaturationCore, maxBands - 1> bandCores;
+    };
+    // Two banks so the outgoing stage keeps its state during the crossfade
+    std::array<std::vector<ChannelGroup>, 2> groupBanks;
+    int activeBank = 0;
+    std::vector<ChannelVector> satScratch;
+    std::vector<ChannelVector> bandScratch;   // bands 1.. of the multiband split, satScratch-sized each
+
+    // Per-block parameter ramps shared by every wet path
+    struct WetRamps {
+        ValueRamp inputGain, preLow, preHigh, postLow, postHigh;
+        ParamRamp saturation;
+        ChannelFilter::Slope postSlope = ChannelFilter::Slope12dB;
+        int satType = 0;
+        int mathTier = MathTier::Exact;
+        int adaaOrder = AdaaOrder::First;
+
+        // Multiband: the bands share the oversampler, filters and latency
+        int numBands = 1;
+        std::array<ValueRamp, maxBands - 1> crossovers;
+        std::array<ParamRamp, maxBands> bandSaturation;
+        std::array<int, maxBands> bandTypes {};
+    };
+
+    // Host-rate wet signal in DSP precision (host I/O stays float); fadeBuffer
+    // carries the outgoing stage during a quality crossfade
+    juce::AudioBuffer<DspSample> wetBuffer, fadeBuffer;
+    juce::AudioBuffer<float> dryBuffer;
+
+    // Dry Signal Delay Compensation: also the latency reported to the host
+    static constexpr int maxLatencySamples = 16384;
+    LatencyCompensator dryCompensator;
 
     // Parameter Smoothers
     juce::LinearSmoothedValue<float> s_inputGain, s_drive, s_character, s_mix, s_outputGain;
     juce::LinearSmoothedValue<float> s_preLow, s_preHigh, s_postLow, s_postHigh;
-
-    // Visualization
-    int visSkipCounter = 0;
-
-    // Auto Gain Variables
-    double agRmsSumIn = 0.0;
-    double agRmsSumOut = 0.0;
-    double agMaxPeakIn = 0.0;
-    int64_t agSampleCountIn = 0;
-    int64_t agSampleCountOut = 0;
-    int64_t agTotalSamplesProcessed = 0;
-    int64_t agTargetSamples = 0;
+    std::array<juce::LinearSmoothedValue<float>, maxBands - 1> s_crossover;
+    std::array<juce::LinearSmoothedValue<float>, maxBands> s_bandDrive, s_bandCharacter;
+
+    // --- Silence / Idle ---
+    // A 48 dB/oct high-pass at 20 Hz takes ~0.55 s to ring down to -120 dB;
+    // the sag envelope (100 ms release) needs ~1.4 s, so idling waits longer
+    // than the reported tail before it stops processing.
+    static constexpr float silenceThreshold = 1.0e-6f;     // -120 dBFS
+    static constexpr double decayTailSeconds = 0.6;
+    static constexpr double idleHoldSeconds = 1.5;
+    int64_t silentSamples = 0;
+    int64_t idleHoldSamples = 0;
+    float lastOutputPeak = 0.0f;
+    bool isIdle = false;
+
+    // AutoGain: the audio thread only feeds the analyser while learning; its
+    // worker measures BS.1770 loudness and true peak, and timerCallback turns
+    // the result into gain changes (host notifications lock and allocate, so
+    // they never run in processBlock)
+    static constexpr double autoGainSeconds = 3.0;
+    AutoGainAnalyser autoGainAnalyser;
     bool agWasLearning = false;
 
-    void updateDspParameters();
-    void updateOversampler(int qualityID, int samplesPerBlock);
+    std::atomic<int> pendingLatency{ -1 };
+
+    void timerCallback() override;
+
+    void updateDspParameters(ParamMask changed);
+    void prepareOversamplers(int samplesPerBlock);
+    void prepareGroupBank(std::vector<ChannelGroup>& bank, int quality);
+    void switchQuality(int qualityID, int filterID, bool holdMaxLatency);
+    double getDspSampleRate(int quality) const;
+    void processWetPath(int quality, int filter, std::vector<ChannelGroup>& bank, juce::AudioBuffer<DspSample>& wet, int numChannels, const WetRamps& ramps);
+    void processBands(ChannelGroup& group, ChannelVector* sat, int n, const WetRamps& ramps);
+    void makeBandRamps(WetRamps& ramps, int hostSamples);
+    void alignWetPath(int bank, juce::AudioBuffer<DspSample>& wet, int numChannels);
+    void processIdleBlock(juce::AudioBuffer<float>& buffer, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NextGenSaturationAudioProcessor)
 };
\ No newline at end of file
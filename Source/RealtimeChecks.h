@@ -0,0 +1,83 @@
+// --- START OF FILE RealtimeChecks.h ---
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <utility>
+
+// ==============================================================================
+// Realtime Safety Checks (test/debug builds)
+// ==============================================================================
+//
+// With NGS_REALTIME_CHECKS=1 PluginProcessor.cpp hooks the global operator
+// new/delete and the C heap underneath them (JUCE's HeapBlock, and so
+// AudioBuffer, allocates with std::malloc/realloc/free): malloc, calloc,
+// realloc, free and the aligned variants are interposed on Linux (glibc) and
+// seen through the debug CRT's allocation hook on Windows. On Linux
+// pthread_mutex_lock is interposed too. Interposing needs the hooks linked into
+// the executable, as in Tools/Benchmark. Any call made by a thread inside a
+// RealtimeScope is counted as a violation and, while trapViolations is set,
+// hits a jassert. Tools/Benchmark --realtime-checks clears trapViolations,
+// drives processBlock through every mode switch and fails if
+// getViolationCount() moved.
+// Without the flag a RealtimeScope compiles to nothing.
+
+#ifndef NGS_REALTIME_CHECKS
+ #define NGS_REALTIME_CHECKS 0
+#endif
+
+namespace RealtimeChecks {
+
+#if NGS_REALTIME_CHECKS
+    enum Violation { Allocation = 0, Deallocation, MutexLock, NumViolations };
+
+    inline std::atomic<int> violationCounts[NumViolations] {};
+    inline std::atomic<bool> trapViolations { true };
+    inline thread_local int scopeDepth = 0;
+
+    inline bool isInRealtimeScope() { return scopeDepth > 0; }
+
+    inline int getViolationCount(Violation v) { return violationCounts[v].load(); }
+    inline int getViolationCount() {
+        int total = 0;
+        for (auto& c : violationCounts) total += c.load();
+        return total;
+    }
+    inline void resetViolationCounts() {
+        for (auto& c : violationCounts) c.store(0);
+    }
+
+    // Leaves the scope for its lifetime, so a hook that calls another hooked
+    // function (operator new -> malloc) is counted once
+    class SuspendScope {
+    public:
+        SuspendScope() : depth(std::exchange(scopeDepth, 0)) {}
+        ~SuspendScope() { scopeDepth = depth; }
+        JUCE_DECLARE_NON_COPYABLE(SuspendScope)
+    private:
+        int depth;
+    };
+
+    // Called from the hooks. The scope is left while reporting, because the
+    // assertion handler itself may allocate.
+    inline void report(Violation v) {
+        if (scopeDepth <= 0) return;
+        SuspendScope suspend;
+        violationCounts[v].fetch_add(1);
+        if (trapViolations.load()) jassertfalse;
+    }
+
+    class RealtimeScope {
+    public:
+        RealtimeScope() { ++scopeDepth; }
+        ~RealtimeScope() { --scopeDepth; }
+        JUCE_DECLARE_NON_COPYABLE(RealtimeScope)
+    };
+#else
+    class RealtimeScope {
+    public:
+        RealtimeScope() = default;
+    };
+#endif
+
+} // namespace RealtimeChecks
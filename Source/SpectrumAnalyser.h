@@ -0,0 +1,122 @@
+// --- START OF FILE SpectrumAnalyser.h ---
+
+#pragma once
+#include <JuceHeader.h>
+#include <cstring>
+#include <vector>
+
+// ==============================================================================
+// Spectrum Analyser (worker thread)
+// ==============================================================================
+//
+// The editor forwards the output telemetry into a lock-free FIFO; a worker
+// runs a Hann-windowed 4096-point FFT every 1024 samples and smooths the
+// magnitudes (instant attack, exponential release) into a dB spectrum that
+// the display copies under a spin lock. Nothing here touches the audio
+// thread: it only exists while an editor is open.
+
+class SpectrumAnalyser : private juce::Thread {
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2 + 1;
+    static constexpr int hopSize = fftSize / 4;
+    static constexpr float floorDB = -120.0f;
+
+    SpectrumAnalyser()
+        : juce::Thread("Spectrum Analyser"),
+          fft(fftOrder),
+          window((size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false) {
+        input.assign((size_t)fifo.getTotalSize(), 0.0f);
+        frame.assign((size_t)fftSize, 0.0f);
+        fftData.assign((size_t)fftSize * 2, 0.0f);
+        smoothed.assign((size_t)numBins, floorDB);
+        published = smoothed;
+
+        // Full-scale sine reads 0 dB: undo the window's coherent gain
+        std::vector<float> ones((size_t)fftSize, 1.0f);
+        window.multiplyWithWindowingTable(ones.data(), (size_t)fftSize);
+        double sum = 0.0;
+        for (float w : ones) sum += w;
+        magnitudeScale = (float)(2.0 / sum);
+
+        startThread();
+    }
+
+    ~SpectrumAnalyser() override { stopThread(1000); }
+
+    // Message thread. Samples that do not fit (worker behind) are dropped.
+    void push(const float* samples, int numSamples) {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        std::memcpy(input.data() + start1, samples, sizeof(float) * (size_t)size1);
+        std::memcpy(input.data() + start2, samples + size1, sizeof(float) * (size_t)size2);
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    // Copies the latest spectrum (dB per bin) if there is a new one
+    bool fetch(std::vector<float>& dest) {
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        if (generation == fetchedGeneration) return false;
+        dest = published;
+        fetchedGeneration = generation;
+        return true;
+    }
+
+private:
+    void run() override {
+        while (!threadShouldExit()) {
+            while (fifo.getNumReady() >= hopSize && !threadShouldExit()) {
+                readHop();
+                analyse();
+            }
+            wait(10);
+        }
+    }
+
+    // Slides the frame along by one hop
+    void readHop() {
+        std::memmove(frame.data(), frame.data() + hopSize, sizeof(float) * (size_t)(fftSize - hopSize));
+        float* tail = frame.data() + fftSize - hopSize;
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead(hopSize, start1, size1, start2, size2);
+        std::memcpy(tail, input.data() + start1, sizeof(float) * (size_t)size1);
+        std::memcpy(tail + size1, input.data() + start2, sizeof(float) * (size_t)size2);
+        fifo.finishedRead(size1 + size2);
+    }
+
+    void analyse() {
+        std::copy(frame.begin(), frame.end(), fftData.begin());
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+        window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        for (int bin = 0; bin < numBins; ++bin) {
+            const float db = juce::Decibels::gainToDecibels(fftData[(size_t)bin] * magnitudeScale, floorDB);
+            float& s = smoothed[(size_t)bin];
+            s = db > s ? db : s + releaseCoeff * (db - s);
+        }
+
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        published = smoothed;
+        ++generation;
+    }
+
+    static constexpr float releaseCoeff = 0.2f;   // per hop
+
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    float magnitudeScale = 1.0f;
+
+    juce::AbstractFifo fifo { 1 << 15 };
+    std::vector<float> input;
+
+    // Worker only
+    std::vector<float> frame, fftData, smoothed;
+
+    juce::SpinLock publishLock;
+    std::vector<float> published;
+    uint32_t generation = 0;
+    uint32_t fetchedGeneration = 0;
+};
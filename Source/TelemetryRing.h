@@ -0,0 +1,151 @@
+// --- START OF FILE TelemetryRing.h ---
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// ==============================================================================
+// 1. Telemetry Ring
+// ==============================================================================
+//
+// Lock-free single-producer/single-consumer ring of parallel sample streams.
+// The audio thread writes whole blocks, one memcpy per stream (two when the
+// write wraps), and returns straight away while no consumer is subscribed.
+// Everything a display needs is derived on the consumer's side (see
+// TelemetryDecimator). A block that does not fit is dropped whole, so the
+// streams never drift apart.
+
+template <int NumStreams>
+class TelemetryRing {
+public:
+    static constexpr int numStreams = NumStreams;
+
+    explicit TelemetryRing(int capacity) : fifo(capacity) {
+        for (auto& s : storage) s.assign((size_t)capacity, 0.0f);
+    }
+
+    // --- Consumer thread (one consumer at a time) ---
+    // Subscribing discards whatever an earlier subscription left behind
+    void subscribe() {
+        discard();
+        subscribed.store(true, std::memory_order_release);
+    }
+    void unsubscribe() { subscribed.store(false, std::memory_order_release); }
+
+    // Hands every ready sample to fn(const float* const* streams, int numSamples),
+    // in at most two chunks. Returns the number of samples read.
+    template <typename Fn>
+    int read(Fn&& fn) {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+        if (size1 > 0) fn(pointersAt(start1).data(), size1);
+        if (size2 > 0) fn(pointersAt(start2).data(), size2);
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    void discard() { fifo.finishedRead(fifo.getNumReady()); }
+
+    // Blocks dropped because the consumer fell behind
+    int getOverrunCount() const { return overruns.load(std::memory_order_relaxed); }
+
+    // --- Audio thread ---
+    bool isSubscribed() const { return subscribed.load(std::memory_order_acquire); }
+
+    // streams[s] == nullptr writes silence
+    void push(const float* const* streams, int numSamples) {
+        if (!isSubscribed()) return;
+        if (fifo.getFreeSpace() < numSamples) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        for (int s = 0; s < NumStreams; ++s) {
+            float* dst = storage[(size_t)s].data();
+            if (const float* src = streams[s]) {
+                std::memcpy(dst + start1, src, sizeof(float) * (size_t)size1);
+                std::memcpy(dst + start2, src + size1, sizeof(float) * (size_t)size2);
+            }
+            else {
+                std::memset(dst + start1, 0, sizeof(float) * (size_t)size1);
+                std::memset(dst + start2, 0, sizeof(float) * (size_t)size2);
+            }
+        }
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    void pushSilence(int numSamples) {
+        const std::array<const float*, NumStreams> none {};
+        push(none.data(), numSamples);
+    }
+
+private:
+    std::array<const float*, NumStreams> pointersAt(int start) const {
+        std::array<const float*, NumStreams> p;
+        for (int s = 0; s < NumStreams; ++s) p[(size_t)s] = storage[(size_t)s].data() + start;
+        return p;
+    }
+
+    juce::AbstractFifo fifo;
+    std::array<std::vector<float>, NumStreams> storage;
+    std::atomic<bool> subscribed { false };
+    std::atomic<int> overruns { 0 };
+};
+
+// ==============================================================================
+// 2. Min/Max Decimator (consumer side)
+// ==============================================================================
+//
+// Reduces a stream to one bucket per samplesPerBucket samples: the bucket's
+// minimum and maximum (so a one-sample transient still reaches the display)
+// and its RMS. A partial bucket carries over to the next read.
+
+struct TelemetryBucket {
+    float min = 0.0f, max = 0.0f, rms = 0.0f;
+
+    float peak() const { return std::max(-min, max); }
+};
+
+class TelemetryDecimator {
+public:
+    TelemetryDecimator() { reset(); }
+
+    void setSamplesPerBucket(int n) {
+        samplesPerBucket = juce::jmax(1, n);
+        reset();
+    }
+
+    void reset() {
+        current = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f };
+        sumSquares = 0.0;
+        count = 0;
+    }
+
+    // Calls emit(const TelemetryBucket&) for every bucket completed by x
+    template <typename Fn>
+    void process(const float* x, int numSamples, Fn&& emit) {
+        for (int i = 0; i < numSamples; ++i) {
+            current.min = std::min(current.min, x[i]);
+            current.max = std::max(current.max, x[i]);
+            sumSquares += (double)x[i] * x[i];
+            if (++count == samplesPerBucket) {
+                current.rms = (float)std::sqrt(sumSquares / count);
+                emit(current);
+                reset();
+            }
+        }
+    }
+
+private:
+    int samplesPerBucket = 8;
+    TelemetryBucket current;
+    double sumSquares = 0.0;
+    int count = 0;
+};
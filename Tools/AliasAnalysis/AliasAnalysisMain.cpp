@@ -0,0 +1,395 @@
+// --- START OF FILE AliasAnalysisMain.cpp ---
+
+// Offline aliasing / accuracy analysis per algorithm and oversampling factor.
+//
+// Build as a JUCE console application (juce_core, juce_audio_basics, juce_dsp)
+// with Source/ on the include path. Every algorithm runs through the same
+// chain as the plugin (Oversampling<double> half-band equiripple stages around
+// SaturationCore) at each drive/character grid point, for coherent sines
+// across the band and a multitone, and is compared with a 64x reference:
+//
+//   alias   energy the chain adds outside the legitimate harmonics (sines) or
+//           above the 64x reference outside the intermodulation lattice
+//           (multitone), dB re output
+//   thd     harmonic distortion of the sine tests, dB re fundamental
+//   refDiff in-band (20 Hz..20 kHz) magnitude-spectrum difference from the
+//           64x reference, dB re reference (includes filter ripple)
+//
+// The summary lists the lowest quality whose worst-case alias stays below
+// --floor, per algorithm and per drive.
+//
+// --curves skips the chain and only compares the static transfer curve of
+// --tier against the exact tier (evaluateCurve), per algorithm over the grid.
+//
+//   NextGenAliasAnalysis [--floor -90] [--rate 48000] [--level -6]
+//                        [--tier exact|fast] [--adaa 1|2] [--curves]
+//                        [--out results.json]
+
+#include <JuceHeader.h>
+#include "../../Source/DspEngine.h"
+
+namespace {
+
+constexpr int fftOrder = 16;
+constexpr int fftSize = 1 << fftOrder;
+constexpr int warmupSamples = 16384;
+constexpr int blockSize = 1024;
+constexpr int referenceStages = 6;     // 64x
+constexpr int numQualities = 5;        // Off, 2x, 4x, 8x, 16x
+constexpr int maxCheckedHarmonic = 1024;
+constexpr int latticeOrder = 7;        // multitone products treated as legitimate
+
+const juce::StringArray algorithmNames{
+    "Analog Tape", "Tube Triode", "Tube Pentode", "Transformer", "Console",
+    "JFET", "BJT", "Diode",
+    "Soft Tanh", "Hard Clip", "Wavefold", "Rectify", "Bitcrush", "Exciter"
+};
+const juce::StringArray qualityNames{ "Off", "2x", "4x", "8x", "16x" };
+const double driveGrid[] = { 0.0, 6.0, 12.0, 18.0, 24.0 };
+const double characterGrid[] = { 0.0, 0.5, 1.0 };
+const double sineFrequencies[] = { 1000.0, 2500.0, 5000.0, 8000.0, 12000.0, 16000.0 };
+const double multitoneFrequencies[] = { 437.0, 1733.0, 3121.0, 6007.0, 9973.0 };
+
+struct Options {
+    double sampleRate = 48000.0;
+    double floorDB = -90.0;
+    double levelDB = -6.0;
+    int mathTier = MathTier::Exact;
+    int adaaOrder = AdaaOrder::First;
+    bool curvesOnly = false;
+    juce::File outFile;
+};
+
+// One test signal, every tone on an exact odd FFT bin: the analysis window is
+// periodic and needs no windowing, and since fftSize is a power of two no
+// harmonic of an odd bin can fold onto another harmonic, DC or Nyquist
+struct TestSignal {
+    juce::String name;
+    std::vector<int> bins;      // input tone bins (odd)
+    std::vector<bool> lattice;  // multitone: legitimate product bins, 0..fftSize/2
+    bool isSine() const { return bins.size() == 1; }
+};
+
+struct Measurement {
+    double aliasDB = 0.0, thdDB = 0.0, refDiffDB = 0.0;
+};
+
+double toDB(double powerRatio) { return 10.0 * std::log10(juce::jmax(powerRatio, 1.0e-30)); }
+
+int toBin(double frequency, double sampleRate) {
+    return juce::jmax(1, juce::roundToInt(frequency * fftSize / sampleRate));
+}
+
+// Nearest odd bin (coherent sampling for the test tones)
+int toToneBin(double frequency, double sampleRate) {
+    const double exact = frequency * fftSize / sampleRate;
+    const int bin = (int)std::floor(exact);
+    const int odd = (bin % 2 != 0) ? bin : (exact - bin >= 0.5 ? bin + 1 : bin - 1);
+    return juce::jlimit(1, fftSize / 2 - 1, odd);
+}
+
+// True if a harmonic above Nyquist (up to maxCheckedHarmonic) folds back onto
+// DC, Nyquist or a harmonic below Nyquist, where the alias measure cannot see it
+bool foldsOntoHarmonic(int bin) {
+    const int half = fftSize / 2;
+    for (int h = 2; h <= maxCheckedHarmonic; ++h) {
+        const int64_t unfolded = (int64_t)h * bin;
+        if (unfolded < half) continue;
+        const int k = (int)(unfolded % fftSize);
+        const int folded = k <= half ? k : fftSize - k;
+        if (folded == 0 || folded == half || folded % bin == 0) return true;
+    }
+    return false;
+}
+
+// Bins of every intermodulation product sum(n_i * f_i) with sum|n_i| <= order
+// that lands below Nyquist without folding
+std::vector<bool> makeLattice(const std::vector<int>& bins, int order) {
+    const int half = fftSize / 2;
+    std::vector<bool> lattice((size_t)half + 1, false);
+    std::vector<int> n(bins.size(), -order);
+    for (;;) {
+        int used = 0;
+        int64_t k = 0;
+        for (size_t i = 0; i < bins.size(); ++i) {
+            used += std::abs(n[i]);
+            k += (int64_t)n[i] * bins[i];
+        }
+        if (used <= order && std::abs(k) <= half) lattice[(size_t)std::abs(k)] = true;
+
+        size_t i = 0;
+        while (i < n.size() && ++n[i] > order) n[i++] = -order;
+        if (i == n.size()) break;
+    }
+    return lattice;
+}
+
+// Runs the saturation chain at 2^stages times the rate and returns the power
+// spectrum (bins 0..fftSize/2) of the last fftSize output samples
+std::vector<double> runChain(const Options& o, const TestSignal& signal, int algorithm, double driveDB, double character, int stages) {
+    std::unique_ptr<juce::dsp::Oversampling<double>> oversampler;
+    if (stages > 0) {
+        oversampler = std::make_unique<juce::dsp::Oversampling<double>>(1, (size_t)stages, juce::dsp::Oversampling<double>::filterHalfBandFIREquiripple, true);
+        oversampler->initProcessing((size_t)blockSize);
+    }
+
+    SaturationCore core;
+    core.prepare(o.sampleRate * (double)(1 << stages));
+    core.reset();
+    core.setAlgorithm(algorithm);
+    core.setMathTier(o.mathTier);
+    core.setAdaaOrder(o.adaaOrder);
+
+    ParamRamp ramp;
+    ramp.driveDB = { driveDB, driveDB };
+    ramp.character = { character, character };
+
+    const double amplitude = juce::Decibels::decibelsToGain(o.levelDB) / (double)signal.bins.size();
+    const int totalSamples = warmupSamples + fftSize;
+    std::vector<double> output((size_t)totalSamples);
+    juce::AudioBuffer<double> buffer(1, blockSize);
+
+    for (int pos = 0; pos < totalSamples; pos += blockSize) {
+        double* d = buffer.getWritePointer(0);
+        for (int i = 0; i < blockSize; ++i) {
+            const int n = (pos + i) % fftSize;
+            double x = 0.0;
+            for (int bin : signal.bins)
+                x += std::sin(juce::MathConstants<double>::twoPi * (double)(((int64_t)bin * n) % fftSize) / fftSize);
+            d[i] = amplitude * x;
+        }
+
+        juce::dsp::AudioBlock<double> block(buffer);
+        auto osBlock = oversampler ? oversampler->processSamplesUp(block) : block;
+        double* s = osBlock.getChannelPointer(0);
+        core.processBlock(s, s, (int)osBlock.getNumSamples(), ramp);
+        if (oversampler) oversampler->processSamplesDown(block);
+
+        std::copy(d, d + blockSize, output.begin() + pos);
+    }
+
+    std::vector<float> fftData((size_t)fftSize * 2, 0.0f);
+    for (int i = 0; i < fftSize; ++i) fftData[(size_t)i] = (float)output[(size_t)(warmupSamples + i)];
+
+    juce::dsp::FFT fft(fftOrder);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    std::vector<double> power((size_t)fftSize / 2 + 1);
+    for (size_t k = 0; k < power.size(); ++k) power[k] = (double)fftData[k] * (double)fftData[k];
+    return power;
+}
+
+Measurement measure(const Options& o, const TestSignal& signal, const std::vector<double>& power, const std::vector<double>& reference) {
+    const int half = fftSize / 2;
+    double total = 0.0;
+    for (int k = 1; k <= half; ++k) total += power[(size_t)k];
+
+    Measurement m;
+
+    if (signal.isSine()) {
+        // Legitimate content: harmonics that stay below Nyquist. Everything
+        // else (folded harmonics, ADAA/bitcrush noise) counts as alias.
+        const int f0 = signal.bins[0];
+        double harmonics = 0.0, fundamental = power[(size_t)f0];
+        for (int k = f0; k < half; k += f0) harmonics += power[(size_t)k];
+        m.aliasDB = toDB((total - harmonics) / total);
+        m.thdDB = toDB((harmonics - fundamental) / juce::jmax(fundamental, 1.0e-30));
+    }
+    else {
+        // Intermodulation products are legitimate. A product folds to the same
+        // bin at every oversampling factor, so the reference's own leakage
+        // sits exactly where the chain aliases: alias is the chain's excess
+        // over the reference, off the lattice
+        double alias = 0.0;
+        for (int k = 1; k <= half; ++k)
+            if (!signal.lattice[(size_t)k]) alias += juce::jmax(0.0, power[(size_t)k] - reference[(size_t)k]);
+        m.aliasDB = toDB(alias / total);
+    }
+
+    const int lo = toBin(20.0, o.sampleRate), hi = juce::jmin(half, toBin(20000.0, o.sampleRate));
+    double diff = 0.0, ref = 0.0;
+    for (int k = lo; k <= hi; ++k) {
+        const double d = std::sqrt(power[(size_t)k]) - std::sqrt(reference[(size_t)k]);
+        diff += d * d;
+        ref += reference[(size_t)k];
+    }
+    m.refDiffDB = toDB(diff / juce::jmax(ref, 1.0e-30));
+    return m;
+}
+
+Options parseOptions(const juce::ArgumentList& args) {
+    Options o;
+    if (args.containsOption("--rate")) o.sampleRate = juce::jmax(8000.0, args.getValueForOption("--rate").getDoubleValue());
+    if (args.containsOption("--floor")) o.floorDB = args.getValueForOption("--floor").getDoubleValue();
+    if (args.containsOption("--level")) o.levelDB = args.getValueForOption("--level").getDoubleValue();
+    if (args.containsOption("--out")) o.outFile = args.getFileForOption("--out");
+    if (args.containsOption("--tier")) {
+        const auto tier = args.getValueForOption("--tier").toLowerCase();
+        o.mathTier = tier == "fast" ? MathTier::Fast : MathTier::Exact;
+    }
+    if (args.containsOption("--adaa"))
+        o.adaaOrder = args.getValueForOption("--adaa").getIntValue() >= 2 ? AdaaOrder::Second : AdaaOrder::First;
+    o.curvesOnly = args.containsOption("--curves");
+    return o;
+}
+
+// Largest static-curve difference between o.mathTier and the exact tier over
+// -2..2 at every drive/character grid point; no state, no oversampling
+int compareCurves(const Options& o) {
+    constexpr int numPoints = 4001;
+    std::vector<double> x(numPoints), exact(numPoints), tier(numPoints);
+    for (int i = 0; i < numPoints; ++i) x[(size_t)i] = -2.0 + 4.0 * i / (numPoints - 1);
+
+    std::printf("%-14s %12s %12s\n", "algorithm", "maxAbsDiff", "maxRelDiff");
+    juce::Array<juce::var> rows;
+    for (int algorithm = 0; algorithm < algorithmNames.size(); ++algorithm) {
+        double maxAbs = 0.0, maxRel = 0.0;
+        for (double driveDB : driveGrid) {
+            for (double character : characterGrid) {
+                evaluateCurve(algorithm, driveDB, character, x.data(), exact.data(), numPoints, MathTier::Exact);
+                evaluateCurve(algorithm, driveDB, character, x.data(), tier.data(), numPoints, o.mathTier);
+                for (int i = 0; i < numPoints; ++i) {
+                    const double d = std::abs(tier[(size_t)i] - exact[(size_t)i]);
+                    maxAbs = juce::jmax(maxAbs, d);
+                    maxRel = juce::jmax(maxRel, d / juce::jmax(std::abs(exact[(size_t)i]), 1.0e-3));
+                }
+            }
+        }
+        std::printf("%-14s %12.3e %12.3e\n", algorithmNames[algorithm].toRawUTF8(), maxAbs, maxRel);
+
+        auto* row = new juce::DynamicObject();
+        row->setProperty("algorithm", algorithmNames[algorithm]);
+        row->setProperty("maxAbsDiff", maxAbs);
+        row->setProperty("maxRelDiff", maxRel);
+        rows.add(juce::var(row));
+    }
+
+    if (o.outFile != juce::File()) {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("mathTier", o.mathTier);
+        root->setProperty("curves", rows);
+        if (!o.outFile.replaceWithText(juce::JSON::toString(juce::var(root)))) {
+            std::fprintf(stderr, "Could not write %s\n", o.outFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto o = parseOptions(juce::ArgumentList(argc, argv));
+    if (o.curvesOnly) return compareCurves(o);
+
+    std::vector<TestSignal> signals;
+    for (double f : sineFrequencies) {
+        if (f >= 0.45 * o.sampleRate) continue;
+        const int bin = toToneBin(f, o.sampleRate);
+        if (foldsOntoHarmonic(bin)) {
+            std::fprintf(stderr, "Sine %.0f Hz (bin %d): a folded harmonic lands on a legitimate one\n", f, bin);
+            return 1;
+        }
+        signals.push_back({ "sine " + juce::String(f, 0) + " Hz", { bin }, {} });
+    }
+    TestSignal multitone{ "multitone", {}, {} };
+    for (double f : multitoneFrequencies) multitone.bins.push_back(toToneBin(f, o.sampleRate));
+    multitone.lattice = makeLattice(multitone.bins, latticeOrder);
+    signals.push_back(multitone);
+
+    // worstAlias[algorithm][drive][quality]: worst case over character and signals
+    const int numDrives = (int)std::size(driveGrid);
+    std::vector<std::vector<std::array<double, numQualities>>> worstAlias(
+        (size_t)algorithmNames.size(), std::vector<std::array<double, numQualities>>((size_t)numDrives));
+    for (auto& perDrive : worstAlias) for (auto& q : perDrive) q.fill(-1000.0);
+
+    juce::Array<juce::var> rows;
+
+    for (int algorithm = 0; algorithm < algorithmNames.size(); ++algorithm) {
+        std::printf("%s\n", algorithmNames[algorithm].toRawUTF8());
+        for (int d = 0; d < numDrives; ++d) {
+            for (double character : characterGrid) {
+                for (const auto& signal : signals) {
+                    const auto reference = runChain(o, signal, algorithm, driveGrid[d], character, referenceStages);
+
+                    for (int quality = 0; quality < numQualities; ++quality) {
+                        const auto power = runChain(o, signal, algorithm, driveGrid[d], character, quality);
+                        const auto m = measure(o, signal, power, reference);
+
+                        auto& worst = worstAlias[(size_t)algorithm][(size_t)d][(size_t)quality];
+                        worst = juce::jmax(worst, m.aliasDB);
+
+                        auto* row = new juce::DynamicObject();
+                        row->setProperty("algorithm", algorithmNames[algorithm]);
+                        row->setProperty("driveDB", driveGrid[d]);
+                        row->setProperty("character", character);
+                        row->setProperty("signal", signal.name);
+                        row->setProperty("quality", qualityNames[quality]);
+                        row->setProperty("aliasDB", m.aliasDB);
+                        if (signal.isSine()) row->setProperty("thdDB", m.thdDB);
+                        row->setProperty("refDiffDB", m.refDiffDB);
+                        rows.add(juce::var(row));
+                    }
+                }
+            }
+        }
+    }
+
+    // --- Summary: lowest quality meeting the floor ---
+    auto lowestQuality = [&](const std::array<double, numQualities>& alias) {
+        for (int q = 0; q < numQualities; ++q) if (alias[(size_t)q] <= o.floorDB) return q;
+        return -1;
+    };
+
+    std::printf("\nLowest quality with alias <= %.1f dB (worst case over character and signals)\n", o.floorDB);
+    std::printf("%-14s", "drive dB");
+    for (double drive : driveGrid) std::printf(" %6.0f", drive);
+    std::printf("    all\n");
+
+    juce::Array<juce::var> summary;
+
+    for (int algorithm = 0; algorithm < algorithmNames.size(); ++algorithm) {
+        std::printf("%-14s", algorithmNames[algorithm].toRawUTF8());
+        std::array<double, numQualities> overall;
+        overall.fill(-1000.0);
+
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("algorithm", algorithmNames[algorithm]);
+        juce::Array<juce::var> byDrive;
+
+        for (int d = 0; d < numDrives; ++d) {
+            const auto& alias = worstAlias[(size_t)algorithm][(size_t)d];
+            for (int q = 0; q < numQualities; ++q) overall[(size_t)q] = juce::jmax(overall[(size_t)q], alias[(size_t)q]);
+
+            const int q = lowestQuality(alias);
+            std::printf(" %6s", q >= 0 ? qualityNames[q].toRawUTF8() : "-");
+            byDrive.add(q >= 0 ? juce::var(qualityNames[q]) : juce::var());
+        }
+
+        const int q = lowestQuality(overall);
+        std::printf(" %6s\n", q >= 0 ? qualityNames[q].toRawUTF8() : "-");
+
+        entry->setProperty("byDrive", byDrive);
+        entry->setProperty("lowestQuality", q >= 0 ? juce::var(qualityNames[q]) : juce::var());
+        summary.add(juce::var(entry));
+    }
+
+    if (o.outFile != juce::File()) {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("sampleRate", o.sampleRate);
+        root->setProperty("floorDB", o.floorDB);
+        root->setProperty("levelDB", o.levelDB);
+        root->setProperty("mathTier", o.mathTier);
+        root->setProperty("adaaOrder", o.adaaOrder + 1);
+        root->setProperty("summary", summary);
+        root->setProperty("measurements", rows);
+        if (!o.outFile.replaceWithText(juce::JSON::toString(juce::var(root)))) {
+            std::fprintf(stderr, "Could not write %s\n", o.outFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+        std::printf("Wrote %s\n", o.outFile.getFullPathName().toRawUTF8());
+    }
+
+    return 0;
+}
@@ -0,0 +1,409 @@
+// --- START OF FILE BenchmarkMain.cpp ---
+
+// Headless processBlock benchmark.
+//
+// Build as a JUCE console application with the plugin's Source/ files (and
+// logo.png as binary data) added, the same modules as the plugin, and
+// JucePlugin_Name defined. Sweeps every algorithm x quality x oversampling
+// filter x post slope x block size and prints ns/sample, CPU fraction of
+// realtime, p99 block time and the reported latency; --out writes the same
+// numbers as JSON for diffing between releases. Every case times the same
+// number of blocks (at least 1000, whatever the block size), so p99 is a
+// percentile rather than the single worst block.
+//
+//   NextGenSaturationBenchmark [--out results.json] [--blocks 1000]
+//                              [--rate 48000] [--drive 12] [--offline]
+//                              [--filter linear|iir|minlat] [--bands 1-4]
+//                              [--realtime-checks]
+//
+// --realtime-checks skips the sweep: built with NGS_REALTIME_CHECKS=1, it
+// drives processBlock through quality and filter switches, Auto quality,
+// AutoGain, multiband, bypass and idle/resume, and exits non-zero if any
+// block allocated, freed or locked a mutex. A last scenario sends a block
+// larger than the prepared size, which has to grow the buffers, and fails
+// unless the hooks caught it. It also checks that resuming from idle does not
+// step: the output after an idling silence has to match the output after a
+// silence too short to idle.
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+namespace {
+
+const juce::StringArray algorithmNames{
+    "Analog Tape", "Tube Triode", "Tube Pentode", "Transformer", "Console",
+    "JFET", "BJT", "Diode",
+    "Soft Tanh", "Hard Clip", "Wavefold", "Rectify", "Bitcrush", "Exciter"
+};
+const juce::StringArray qualityNames{ "Off", "2x", "4x", "8x", "16x" };
+const juce::StringArray filterNames{ "linear", "iir", "minlat" };
+const juce::StringArray slopeNames{ "6 dB/oct", "12 dB/oct", "24 dB/oct", "48 dB/oct" };
+const int blockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+constexpr int minTimedBlocks = 1000;
+
+struct Options {
+    juce::File outFile;
+    int timedBlocks = minTimedBlocks;
+    double sampleRate = 48000.0;
+    float driveDB = 12.0f;
+    bool offline = false;
+    int onlyFilter = -1;    // -1: every filter family
+    int numBands = 1;       // multiband mode, every band on the main algorithm
+    bool realtimeChecks = false;
+};
+
+struct Result {
+    int satType = 0, quality = 0, osFilter = 0, postSlope = 0, blockSize = 0;
+    int latencySamples = 0;
+    double nsPerSample = 0.0;   // per sample frame (all channels)
+    double cpuFraction = 0.0;   // processing time / audio time
+    double p99BlockMicros = 0.0;
+    double p99Fraction = 0.0;   // p99 block time / block duration
+};
+
+Options parseOptions(const juce::ArgumentList& args) {
+    Options o;
+    if (args.containsOption("--out")) o.outFile = args.getFileForOption("--out");
+    if (args.containsOption("--blocks")) o.timedBlocks = juce::jmax(minTimedBlocks, args.getValueForOption("--blocks").getIntValue());
+    if (args.containsOption("--rate")) o.sampleRate = juce::jmax(8000.0, args.getValueForOption("--rate").getDoubleValue());
+    if (args.containsOption("--drive")) o.driveDB = args.getValueForOption("--drive").getFloatValue();
+    o.offline = args.containsOption("--offline");
+    if (args.containsOption("--filter")) o.onlyFilter = filterNames.indexOf(args.getValueForOption("--filter").toLowerCase());
+    if (args.containsOption("--bands")) o.numBands = juce::jlimit(1, 4, args.getValueForOption("--bands").getIntValue());
+    o.realtimeChecks = args.containsOption("--realtime-checks");
+    return o;
+}
+
+void setParameter(NextGenSaturationAudioProcessor& p, const juce::String& id, float value) {
+    if (auto* param = p.apvts.getParameter(id)) param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+// Stereo program material: two detuned tones plus a little noise, -6 dBFS peak
+juce::AudioBuffer<float> makeTestSignal(double sampleRate, int numSamples) {
+    juce::AudioBuffer<float> signal(2, numSamples);
+    juce::Random random(1234);
+    for (int ch = 0; ch < 2; ++ch) {
+        auto* d = signal.getWritePointer(ch);
+        const double f1 = 110.0 * (ch + 1), f2 = 1375.0 + 11.0 * ch;
+        for (int i = 0; i < numSamples; ++i) {
+            const double t = (double)i / sampleRate;
+            d[i] = (float)(0.3 * std::sin(juce::MathConstants<double>::twoPi * f1 * t)
+                         + 0.15 * std::sin(juce::MathConstants<double>::twoPi * f2 * t)
+                         + 0.05 * (random.nextDouble() * 2.0 - 1.0));
+        }
+    }
+    return signal;
+}
+
+Result runCase(const Options& o, const juce::AudioBuffer<float>& signal, int satType, int quality, int osFilter, int postSlope, int blockSize) {
+    NextGenSaturationAudioProcessor processor;
+    processor.setNonRealtime(o.offline);
+    processor.setPlayConfigDetails(2, 2, o.sampleRate, blockSize);
+
+    setParameter(processor, "satType", (float)satType);
+    setParameter(processor, "quality", (float)quality);
+    setParameter(processor, "osFilter", (float)osFilter);
+    setParameter(processor, "postSlope", (float)postSlope);
+    setParameter(processor, "drive", o.driveDB);
+    setParameter(processor, "character", 0.5f);
+    setParameter(processor, "preLowCut", 30.0f);
+    setParameter(processor, "postHighCut", 18000.0f);
+    setParameter(processor, "bands", (float)(o.numBands - 1));
+    processor.prepareToPlay(o.sampleRate, blockSize);
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    int readPos = 0;
+    auto fillBlock = [&] {
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < blockSize; ++i)
+                block.setSample(ch, i, signal.getSample(ch, (readPos + i) % signal.getNumSamples()));
+        }
+        readPos = (readPos + blockSize) % signal.getNumSamples();
+    };
+
+    // Warm up past the parameter smoothing and the first cache misses
+    const int warmupBlocks = juce::jmax(4, (int)(0.1 * o.sampleRate) / blockSize);
+    for (int b = 0; b < warmupBlocks; ++b) {
+        fillBlock();
+        processor.processBlock(block, midi);
+    }
+
+    const int numBlocks = o.timedBlocks;
+    std::vector<double> blockSeconds((size_t)numBlocks);
+    double totalSeconds = 0.0;
+
+    for (int b = 0; b < numBlocks; ++b) {
+        fillBlock(); // outside the timed region
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midi);
+        const auto end = juce::Time::getHighResolutionTicks();
+
+        blockSeconds[(size_t)b] = juce::Time::highResolutionTicksToSeconds(end - start);
+        totalSeconds += blockSeconds[(size_t)b];
+    }
+
+    const size_t p99Index = juce::jmin(blockSeconds.size() - 1, (size_t)std::ceil(0.99 * (double)blockSeconds.size()) - 1);
+    std::nth_element(blockSeconds.begin(), blockSeconds.begin() + (std::ptrdiff_t)p99Index, blockSeconds.end());
+
+    const double audioSeconds = (double)numBlocks * blockSize / o.sampleRate;
+    const double blockDuration = blockSize / o.sampleRate;
+
+    Result r;
+    r.satType = satType; r.quality = quality; r.osFilter = osFilter; r.postSlope = postSlope; r.blockSize = blockSize;
+    r.latencySamples = processor.getLatencySamples();
+    r.nsPerSample = totalSeconds * 1.0e9 / ((double)numBlocks * blockSize);
+    r.cpuFraction = totalSeconds / audioSeconds;
+    r.p99BlockMicros = blockSeconds[p99Index] * 1.0e6;
+    r.p99Fraction = blockSeconds[p99Index] / blockDuration;
+    return r;
+}
+
+juce::var toJson(const Options& o, const std::vector<Result>& results) {
+    auto* root = new juce::DynamicObject();
+    root->setProperty("plugin", JucePlugin_Name);
+    root->setProperty("dspPrecision", NGS_DSP_FLOAT ? "float" : "double");
+    root->setProperty("sampleRate", o.sampleRate);
+    root->setProperty("blocksPerCase", o.timedBlocks);
+    root->setProperty("driveDB", o.driveDB);
+    root->setProperty("offline", o.offline);
+    root->setProperty("bands", o.numBands);
+    root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("cpu", juce::SystemStats::getCpuModel());
+
+    juce::Array<juce::var> cases;
+    for (const auto& r : results) {
+        auto* c = new juce::DynamicObject();
+        c->setProperty("satType", algorithmNames[r.satType]);
+        c->setProperty("quality", qualityNames[r.quality]);
+        c->setProperty("osFilter", filterNames[r.osFilter]);
+        c->setProperty("latencySamples", r.latencySamples);
+        c->setProperty("postSlope", slopeNames[r.postSlope]);
+        c->setProperty("blockSize", r.blockSize);
+        c->setProperty("nsPerSample", r.nsPerSample);
+        c->setProperty("cpuFraction", r.cpuFraction);
+        c->setProperty("p99BlockMicros", r.p99BlockMicros);
+        c->setProperty("p99Fraction", r.p99Fraction);
+        cases.add(juce::var(c));
+    }
+    root->setProperty("cases", cases);
+    return juce::var(root);
+}
+
+#if NGS_REALTIME_CHECKS
+// Renders a biased shape (Soft Tanh at full character, quality Off) through
+// signal, `silenceSeconds` of digital silence and signal again, and returns
+// the first channel of the last part
+std::vector<float> renderResume(const Options& o, double silenceSeconds) {
+    constexpr int blockSize = 256;
+    NextGenSaturationAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, o.sampleRate, blockSize);
+    setParameter(processor, "drive", o.driveDB);
+    setParameter(processor, "satType", 8.0f);
+    setParameter(processor, "character", 1.0f);
+    setParameter(processor, "quality", 0.0f);
+    processor.prepareToPlay(o.sampleRate, blockSize);
+
+    const auto signal = makeTestSignal(o.sampleRate, (int)o.sampleRate);
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    std::vector<float> resumed;
+
+    auto run = [&](double seconds, bool silent, bool keep) {
+        for (int pos = 0; pos < (int)(seconds * o.sampleRate); pos += blockSize) {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    block.setSample(ch, i, silent ? 0.0f : signal.getSample(ch, (pos + i) % signal.getNumSamples()));
+            processor.processBlock(block, midi);
+            if (keep) resumed.insert(resumed.end(), block.getReadPointer(0), block.getReadPointer(0) + blockSize);
+        }
+    };
+    run(0.5, false, false);
+    run(silenceSeconds, true, false);
+    run(0.1, false, true);
+
+    processor.releaseResources();
+    return resumed;
+}
+#endif
+
+// Realtime safety: every scenario runs with the hooks counting instead of
+// asserting; returns the number of failed scenarios
+int runRealtimeChecks(const Options& o) {
+   #if NGS_REALTIME_CHECKS
+    constexpr int maxBlockSize = 512;
+    const int blockSizes[] = { 512, 256, 64, 1, 333 };   // hosts may send anything up to the prepared size
+
+    NextGenSaturationAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, o.sampleRate, maxBlockSize);
+    setParameter(processor, "drive", o.driveDB);
+    processor.prepareToPlay(o.sampleRate, maxBlockSize);
+
+    const auto signal = makeTestSignal(o.sampleRate, (int)o.sampleRate);
+    juce::AudioBuffer<float> block(2, maxBlockSize);
+    juce::MidiBuffer midi;
+    int readPos = 0, sizeIndex = 0;
+
+    // Processes about `seconds` of audio at `gain` (0 = digital silence)
+    auto run = [&](double seconds, float gain) {
+        for (int done = 0; done < (int)(seconds * o.sampleRate);) {
+            const int n = blockSizes[sizeIndex++ % (int)std::size(blockSizes)];
+            juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), 2, n);
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < n; ++i)
+                    view.setSample(ch, i, gain * signal.getSample(ch, (readPos + i) % signal.getNumSamples()));
+            }
+            readPos = (readPos + n) % signal.getNumSamples();
+            processor.processBlock(view, midi);
+            done += n;
+        }
+    };
+
+    RealtimeChecks::trapViolations = false;
+    int failures = 0;
+    auto scenario = [&](const char* name, auto&& body, bool expectViolations = false) {
+        RealtimeChecks::resetViolationCounts();
+        body();
+        const int allocations = RealtimeChecks::getViolationCount(RealtimeChecks::Allocation);
+        const int frees = RealtimeChecks::getViolationCount(RealtimeChecks::Deallocation);
+        const int locks = RealtimeChecks::getViolationCount(RealtimeChecks::MutexLock);
+        const bool ok = (allocations + frees + locks > 0) == expectViolations;
+        std::printf("%-28s %s  (alloc %d, free %d, lock %d)\n", name, ok ? "ok  " : "FAIL", allocations, frees, locks);
+        if (!ok) ++failures;
+    };
+
+    scenario("steady state", [&] { run(1.0, 1.0f); });
+    scenario("quality x filter switches", [&] {
+        for (int filter = 0; filter < filterNames.size(); ++filter) {
+            setParameter(processor, "osFilter", (float)filter);
+            for (int quality = 0; quality < qualityNames.size(); ++quality) {
+                setParameter(processor, "quality", (float)quality);
+                run(0.1, 1.0f);
+            }
+        }
+    });
+    scenario("auto quality", [&] {
+        setParameter(processor, "quality", (float)NextGenSaturationAudioProcessor::autoQualityChoice);
+        for (float gain : { 0.01f, 1.0f, 0.05f, 1.0f, 0.01f }) run(0.7, gain);   // up at once, down after the hold
+        setParameter(processor, "quality", 2.0f);
+        run(0.1, 1.0f);
+        setParameter(processor, "quality", (float)NextGenSaturationAudioProcessor::autoQualityChoice);
+        run(0.1, 1.0f);
+    });
+    scenario("algorithms, tiers, adaa", [&] {
+        for (int satType = 0; satType < algorithmNames.size(); ++satType) {
+            setParameter(processor, "satType", (float)satType);
+            setParameter(processor, "mathTier", (float)(satType % 3));
+            setParameter(processor, "adaaOrder", (float)(satType % 2));
+            run(0.05, 1.0f);
+        }
+    });
+    scenario("multiband", [&] {
+        for (int bands = 3; bands >= 0; --bands) {
+            setParameter(processor, "bands", (float)bands);
+            setParameter(processor, "band2Type", (float)(bands + 2));
+            run(0.1, 1.0f);
+        }
+    });
+    scenario("autogain", [&] {
+        setParameter(processor, "autoGain", 1.0f);
+        run(1.0, 1.0f);
+        setParameter(processor, "autoGain", 0.0f);   // cancelled mid-session
+        run(0.1, 1.0f);
+        setParameter(processor, "autoGain", 1.0f);
+        run(4.0, 1.0f);                              // completes; the result waits for the message thread
+        setParameter(processor, "autoGain", 0.0f);
+        run(0.1, 1.0f);
+    });
+    scenario("bypass", [&] {
+        setParameter(processor, "bypass", 1.0f);
+        run(0.2, 1.0f);
+        setParameter(processor, "bypass", 0.0f);
+        run(0.2, 1.0f);
+    });
+    scenario("idle and resume", [&] {
+        run(3.0, 0.0f);   // past the idle hold
+        run(0.5, 1.0f);
+    });
+
+    // Negative control: AudioBuffer grows through HeapBlock (std::malloc/free),
+    // so the hooks have to see it. Off and one band, whose other scratch
+    // covers 16x the prepared size.
+    scenario("oversized block (expected)", [&] {
+        setParameter(processor, "quality", 0.0f);
+        setParameter(processor, "bands", 0.0f);
+        run(0.1, 1.0f);
+        juce::AudioBuffer<float> large(2, maxBlockSize * 2);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < large.getNumSamples(); ++i) large.setSample(ch, i, signal.getSample(ch, i % signal.getNumSamples()));
+        RealtimeChecks::resetViolationCounts();
+        processor.processBlock(large, midi);
+    }, true);
+
+    // Idling must not step on resume: after a silence long enough to idle,
+    // the output has to match one whose silence was too short to idle
+    {
+        const auto idled = renderResume(o, 3.0), awake = renderResume(o, 1.0);
+        float worst = 0.0f;
+        for (size_t i = 0; i < idled.size(); ++i) worst = std::max(worst, std::abs(idled[i] - awake[i]));
+        const bool ok = worst < juce::Decibels::decibelsToGain(-90.0f);
+        std::printf("%-28s %s  (max difference %.1f dB)\n", "idle resume transient", ok ? "ok  " : "FAIL", juce::Decibels::gainToDecibels(worst, -200.0f));
+        if (!ok) ++failures;
+    }
+
+    processor.releaseResources();
+    std::printf("%s\n", failures == 0 ? "No realtime violations." : "Realtime violations found.");
+    return failures;
+   #else
+    juce::ignoreUnused(o);
+    std::fprintf(stderr, "--realtime-checks needs a build with NGS_REALTIME_CHECKS=1\n");
+    return -1;
+   #endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    const auto options = parseOptions(juce::ArgumentList(argc, argv));
+    if (options.realtimeChecks) return runRealtimeChecks(options) == 0 ? 0 : 1;
+
+    const auto signal = makeTestSignal(options.sampleRate, (int)options.sampleRate);
+    std::vector<Result> results;
+
+    std::printf("%-14s %-5s %-7s %-10s %6s %10s %8s %10s %8s %7s\n",
+        "algorithm", "os", "filter", "slope", "block", "ns/sample", "cpu", "p99 us", "p99/blk", "latency");
+
+    for (int satType = 0; satType < algorithmNames.size(); ++satType) {
+        for (int quality = 0; quality < qualityNames.size(); ++quality) {
+            for (int osFilter = 0; osFilter < filterNames.size(); ++osFilter) {
+                // Off has no filters: run it once
+                if (options.onlyFilter >= 0 ? osFilter != options.onlyFilter : (quality == 0 && osFilter > 0)) continue;
+
+                for (int postSlope = 0; postSlope < slopeNames.size(); ++postSlope) {
+                    for (int blockSize : blockSizes) {
+                        const auto r = runCase(options, signal, satType, quality, osFilter, postSlope, blockSize);
+                        results.push_back(r);
+                        std::printf("%-14s %-5s %-7s %-10s %6d %10.2f %7.3f%% %10.1f %7.2f%% %7d\n",
+                            algorithmNames[satType].toRawUTF8(), qualityNames[quality].toRawUTF8(),
+                            filterNames[osFilter].toRawUTF8(), slopeNames[postSlope].toRawUTF8(), blockSize,
+                            r.nsPerSample, r.cpuFraction * 100.0, r.p99BlockMicros, r.p99Fraction * 100.0, r.latencySamples);
+                        std::fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+
+    if (options.outFile != juce::File()) {
+        if (!options.outFile.replaceWithText(juce::JSON::toString(toJson(options, results)))) {
+            std::fprintf(stderr, "Could not write %s\n", options.outFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+        std::printf("Wrote %s\n", options.outFile.getFullPathName().toRawUTF8());
+    }
+
+    return 0;
+}